@@ -19,6 +19,6 @@ public class ALSV4_CPP : ModuleRules
 			"PhysicsCore", "Niagara"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new[] {"Slate", "SlateCore"});
+		PrivateDependencyModuleNames.AddRange(new[] {"Slate", "SlateCore", "NetCore"});
 	}
 }
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "Character/Animation/ALSCharacterAnimInstance.h"
 #include "Character/Animation/ALSPlayerCameraBehavior.h"
 #include "Library/ALSMathLibrary.h"
+#include "Library/ALSMontageRegistry.h"
 #include "Components/ALSDebugComponent.h"
 
 #include "Components/CapsuleComponent.h"
@@ -20,8 +21,10 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameFramework/GameStateBase.h"
 #include "TimerManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 
 const FName NAME_FP_Camera(TEXT("FP_Camera"));
@@ -97,18 +100,18 @@ void AALSBaseCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Ou
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AALSBaseCharacter, TargetRagdollLocation);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedCurrentAcceleration, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedControlRotation, COND_SkipOwner);
+	/* 所有属性都使用 Push Model，只在 setter 里标记为脏时才进行比较 */
+	FDoRepLifetimeParams SharedParams;
+	SharedParams.bIsPushBased = true;
 
-	DOREPLIFETIME(AALSBaseCharacter, DesiredGait);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, DesiredStance, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, DesiredRotationMode, COND_SkipOwner);
+	SharedParams.Condition = COND_SkipOwner;
 
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, RotationMode, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, OverlayState, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ViewMode, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, VisibleMesh, COND_SkipOwner);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AALSBaseCharacter, RagdollNetLocation, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AALSBaseCharacter, ReplicatedAimAccel, SharedParams);
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AALSBaseCharacter, ReplicatedLocomotionState, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AALSBaseCharacter, VisibleMesh, SharedParams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AALSBaseCharacter, CurrentMontage, SharedParams);
 }
 
 void AALSBaseCharacter::OnBreakfall_Implementation()
@@ -123,7 +126,31 @@ void AALSBaseCharacter::Replicated_PlayMontage_Implementation(UAnimMontage* Mont
 	{
 		MainAnimInstance->Montage_Play(Montage, PlayRate);
 	}
-	Server_PlayMontage(Montage, PlayRate);
+
+	/* 不在 MontageRegistry 中的蒙太奇退回到按对象引用同步 */
+	const uint8 MontageId = MontageRegistry ? MontageRegistry->FindMontageId(Montage) : 0;
+	if (MontageId == 0)
+	{
+		if (HasAuthority())
+		{
+			Multicast_PlayMontage(Montage, PlayRate);
+		}
+		else
+		{
+			Server_PlayMontage(Montage, PlayRate);
+		}
+		return;
+	}
+
+	const uint8 PackedPlayRate = UALSMontageRegistry::PackPlayRate(PlayRate);
+	if (HasAuthority())
+	{
+		BroadcastMontage(MontageId, PackedPlayRate);
+	}
+	else
+	{
+		Server_PlayMontageById(MontageId, PackedPlayRate);
+	}
 }
 
 void AALSBaseCharacter::BeginPlay()
@@ -250,6 +277,14 @@ void AALSBaseCharacter::RagdollStart()
 	TargetRagdollLocation = GetMesh()->GetSocketLocation(NAME_Pelvis);
 	ServerRagdollPull = 0;
 
+	/* 重置骨盆位置的发送状态和插值缓冲 */
+	LastSentRagdollLocation = TargetRagdollLocation;
+	LastRagdollSendTime = -1.0f;
+	RagdollNetBuffer.Reset();
+	bRagdollAtRest = false;
+	RagdollRestTime = 0.0f;
+	RagdollSpringLevel = INDEX_NONE;
+
 	/* 步骤1:清除角色移动模式，设置移动状态为 Ragdoll */
 	GetCharacterMovement()->SetMovementMode(MOVE_None);
 	SetMovementState(EALSMovementState::Ragdoll);
@@ -329,9 +364,36 @@ void AALSBaseCharacter::RagdollEnd()
 	}
 }
 
-void AALSBaseCharacter::Server_SetMeshLocationDuringRagdoll_Implementation(FVector MeshLocation)
+void AALSBaseCharacter::Server_SetMeshLocationDuringRagdoll_Implementation(FVector_NetQuantize10 MeshLocation)
 {
 	TargetRagdollLocation = MeshLocation;
+	RagdollNetLocation = MeshLocation;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AALSBaseCharacter, RagdollNetLocation, this);
+
+	/* 静止的布娃娃不会更新，收到新位置后唤醒 */
+	if (bRagdollAtRest)
+	{
+		SetRagdollAtRest(false);
+	}
+}
+
+void AALSBaseCharacter::OnRep_RagdollNetLocation()
+{
+	/* 只保留最近的几个采样 */
+	if (RagdollNetBuffer.Num() >= 4)
+	{
+		RagdollNetBuffer.RemoveAt(0, 1, false);
+	}
+
+	FALSRagdollNetSample& Sample = RagdollNetBuffer.AddDefaulted_GetRef();
+	Sample.Time = GetWorld()->GetTimeSeconds();
+	Sample.Location = RagdollNetLocation;
+
+	/* 权威位置还在变化，唤醒本地的布娃娃 */
+	if (bRagdollAtRest)
+	{
+		SetRagdollAtRest(false);
+	}
 }
 
 void AALSBaseCharacter::SetMovementState(const EALSMovementState NewState, bool bForce)
@@ -379,13 +441,10 @@ void AALSBaseCharacter::SetGait(const EALSGait NewGait, bool bForce)
 void AALSBaseCharacter::SetDesiredStance(EALSStance NewStance)
 {
 	DesiredStance = NewStance;
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		Server_SetDesiredStance(NewStance);
-	}
+	UpdateReplicatedLocomotionState();
 }
 
-void AALSBaseCharacter::Server_SetDesiredStance_Implementation(EALSStance NewStance)
+void AALSBaseCharacter::Server_SetDesiredStance(EALSStance NewStance)
 {
 	SetDesiredStance(NewStance);
 }
@@ -393,10 +452,12 @@ void AALSBaseCharacter::Server_SetDesiredStance_Implementation(EALSStance NewSta
 void AALSBaseCharacter::SetDesiredGait(const EALSGait NewGait)
 {
 	DesiredGait = NewGait;
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		Server_SetDesiredGait(NewGait);
-	}
+	UpdateReplicatedLocomotionState();
+}
+
+void AALSBaseCharacter::Server_SetDesiredGait(EALSGait NewGait)
+{
+	SetDesiredGait(NewGait);
 }
 
 void AALSBaseCharacter::SetDesiredLaddering(bool NewState)
@@ -407,11 +468,11 @@ void AALSBaseCharacter::SetDesiredLaddering(bool NewState)
 	{
 		MainAnimInstance->bDesiredLaddering = bDesiredLaddering;
 	}
+}
 
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		Server_SetDesiredLaddering(NewState);
-	}
+void AALSBaseCharacter::Server_SetDesiredLaddering(bool NewState)
+{
+	SetDesiredLaddering(NewState);
 }
 
 void AALSBaseCharacter::SetRotateInClimbAngle(float Angle)
@@ -459,27 +520,13 @@ void AALSBaseCharacter::SetAnimClimbCornerParam(float TimeLength, float StartTim
 	}
 }
 
-void AALSBaseCharacter::Server_SetDesiredLaddering_Implementation(bool NewState)
-{
-	SetDesiredLaddering(NewState);
-}
-
-
-void AALSBaseCharacter::Server_SetDesiredGait_Implementation(EALSGait NewGait)
-{
-	SetDesiredGait(NewGait);
-}
-
 void AALSBaseCharacter::SetDesiredRotationMode(EALSRotationMode NewRotMode)
 {
 	DesiredRotationMode = NewRotMode;
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		Server_SetDesiredRotationMode(NewRotMode);
-	}
+	UpdateReplicatedLocomotionState();
 }
 
-void AALSBaseCharacter::Server_SetDesiredRotationMode_Implementation(EALSRotationMode NewRotMode)
+void AALSBaseCharacter::Server_SetDesiredRotationMode(EALSRotationMode NewRotMode)
 {
 	SetDesiredRotationMode(NewRotMode);
 }
@@ -490,17 +537,12 @@ void AALSBaseCharacter::SetRotationMode(const EALSRotationMode NewRotationMode,
 	{
 		const EALSRotationMode Prev = RotationMode;
 		RotationMode = NewRotationMode;
+		UpdateReplicatedLocomotionState();
 		OnRotationModeChanged(Prev);
-
-		if (GetLocalRole() == ROLE_AutonomousProxy)
-		{
-			Server_SetRotationMode(NewRotationMode, bForce);
-		}
 	}
 }
 
-
-void AALSBaseCharacter::Server_SetRotationMode_Implementation(EALSRotationMode NewRotationMode, bool bForce)
+void AALSBaseCharacter::Server_SetRotationMode(EALSRotationMode NewRotationMode, bool bForce)
 {
 	SetRotationMode(NewRotationMode, bForce);
 }
@@ -511,12 +553,8 @@ void AALSBaseCharacter::SetViewMode(const EALSViewMode NewViewMode, bool bForce)
 	{
 		const EALSViewMode Prev = ViewMode;
 		ViewMode = NewViewMode;
+		UpdateReplicatedLocomotionState();
 		OnViewModeChanged(Prev);
-
-		if (GetLocalRole() == ROLE_AutonomousProxy)
-		{
-			Server_SetViewMode(NewViewMode, bForce);
-		}
 	}
 }
 
@@ -525,22 +563,17 @@ void AALSBaseCharacter::SetCanInputMove(bool NewState, bool bForce)
 	if (bForce || bCanInputMove != NewState)
 	{
 		bCanInputMove = NewState;
-
-		if (GetLocalRole() == ROLE_AutonomousProxy)
-		{
-			Server_SetCanInputMove(NewState, bForce);
-		}
 	}
 }
 
-void AALSBaseCharacter::Server_SetCanInputMove_Implementation(bool NewState, bool bForce)
+void AALSBaseCharacter::Server_SetViewMode(EALSViewMode NewViewMode, bool bForce)
 {
-	SetCanInputMove(NewState, bForce);
+	SetViewMode(NewViewMode, bForce);
 }
 
-void AALSBaseCharacter::Server_SetViewMode_Implementation(EALSViewMode NewViewMode, bool bForce)
+void AALSBaseCharacter::Server_SetCanInputMove(bool NewState, bool bForce)
 {
-	SetViewMode(NewViewMode, bForce);
+	SetCanInputMove(NewState, bForce);
 }
 
 void AALSBaseCharacter::SetOverlayState(const EALSOverlayState NewState, bool bForce)
@@ -549,17 +582,12 @@ void AALSBaseCharacter::SetOverlayState(const EALSOverlayState NewState, bool bF
 	{
 		const EALSOverlayState Prev = OverlayState;
 		OverlayState = NewState;
+		UpdateReplicatedLocomotionState();
 		OnOverlayStateChanged(Prev);
-
-		if (GetLocalRole() == ROLE_AutonomousProxy)
-		{
-			Server_SetOverlayState(NewState, bForce);
-		}
 	}
 }
 
-
-void AALSBaseCharacter::Server_SetOverlayState_Implementation(EALSOverlayState NewState, bool bForce)
+void AALSBaseCharacter::Server_SetOverlayState(EALSOverlayState NewState, bool bForce)
 {
 	SetOverlayState(NewState, bForce);
 }
@@ -623,7 +651,7 @@ void AALSBaseCharacter::AddOverlayState(EALSOverlayState State)
 
 void AALSBaseCharacter::Server_PlayMontage_Implementation(UAnimMontage* Montage, float PlayRate)
 {
-	if (MainAnimInstance)
+	if (MainAnimInstance && Montage)
 	{
 		MainAnimInstance->Montage_Play(Montage, PlayRate);
 	}
@@ -635,9 +663,73 @@ void AALSBaseCharacter::Server_PlayMontage_Implementation(UAnimMontage* Montage,
 
 void AALSBaseCharacter::Multicast_PlayMontage_Implementation(UAnimMontage* Montage, float PlayRate)
 {
-	if (MainAnimInstance && !IsLocallyControlled())
+	if (GetLocalRole() == ROLE_SimulatedProxy)
 	{
-		MainAnimInstance->Montage_Play(Montage, PlayRate);
+		PlayReplicatedMontage(Montage, PlayRate);
+	}
+}
+
+void AALSBaseCharacter::Server_PlayMontageById_Implementation(uint8 MontageId, uint8 PackedPlayRate)
+{
+	UAnimMontage* Montage = MontageRegistry ? MontageRegistry->GetMontageById(MontageId) : nullptr;
+	if (!Montage)
+	{
+		return;
+	}
+
+	if (MainAnimInstance)
+	{
+		MainAnimInstance->Montage_Play(Montage, UALSMontageRegistry::UnpackPlayRate(PackedPlayRate));
+	}
+
+	BroadcastMontage(MontageId, PackedPlayRate);
+}
+
+void AALSBaseCharacter::Multicast_PlayMontageById_Implementation(uint8 MontageId, uint8 PackedPlayRate)
+{
+	if (GetLocalRole() == ROLE_SimulatedProxy && MontageRegistry)
+	{
+		PlayReplicatedMontage(MontageRegistry->GetMontageById(MontageId),
+		                      UALSMontageRegistry::UnpackPlayRate(PackedPlayRate));
+	}
+}
+
+void AALSBaseCharacter::BroadcastMontage(uint8 MontageId, uint8 PackedPlayRate)
+{
+	CurrentMontage.MontageId = MontageId;
+	CurrentMontage.PackedPlayRate = PackedPlayRate;
+	CurrentMontage.PlayCount++;
+	CurrentMontage.StartTime = GetWorld()->GetTimeSeconds();
+	MARK_PROPERTY_DIRTY_FROM_NAME(AALSBaseCharacter, CurrentMontage, this);
+
+	/* 强制更新数据 */
+	ForceNetUpdate();
+	Multicast_PlayMontageById(MontageId, PackedPlayRate);
+}
+
+void AALSBaseCharacter::PlayReplicatedMontage(UAnimMontage* Montage, float PlayRate, float StartPosition)
+{
+	if (MainAnimInstance && Montage && !MainAnimInstance->Montage_IsPlaying(Montage))
+	{
+		MainAnimInstance->Montage_Play(Montage, PlayRate, EMontagePlayReturnType::MontageLength, StartPosition);
+	}
+}
+
+/* 多播丢失或者刚加入游戏时，从蒙太奇已经播放的位置开始补播 */
+void AALSBaseCharacter::OnRep_CurrentMontage()
+{
+	UAnimMontage* Montage = MontageRegistry ? MontageRegistry->GetMontageById(CurrentMontage.MontageId) : nullptr;
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (!Montage || !GameState)
+	{
+		return;
+	}
+
+	const float PlayRate = UALSMontageRegistry::UnpackPlayRate(CurrentMontage.PackedPlayRate);
+	const float Position = (GameState->GetServerWorldTimeSeconds() - CurrentMontage.StartTime) * PlayRate;
+	if (Position < Montage->GetPlayLength())
+	{
+		PlayReplicatedMontage(Montage, PlayRate, FMath::Max(Position, 0.0f));
 	}
 }
 
@@ -839,6 +931,7 @@ void AALSBaseCharacter::SetVisibleMesh(USkeletalMesh* NewVisibleMesh)
 	{
 		const USkeletalMesh* Prev = VisibleMesh;
 		VisibleMesh = NewVisibleMesh;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AALSBaseCharacter, VisibleMesh, this);
 		OnVisibleMeshChanged(Prev);
 
 		if (GetLocalRole() != ROLE_Authority)
@@ -903,6 +996,16 @@ void AALSBaseCharacter::SetAcceleration(const FVector& NewAcceleration)
  */
 void AALSBaseCharacter::RagdollUpdate(float DeltaTime)
 {
+	if (bRagdollAtRest)
+	{
+		/* 受到冲击后刚体会被唤醒，这时恢复布娃娃的更新 */
+		if (!GetMesh()->IsAnyRigidBodyAwake())
+		{
+			return;
+		}
+		SetRagdollAtRest(false);
+	}
+
 	/* 获得单个物体的线速度 */
 	const FVector NewRagdollVel = GetMesh()->GetPhysicsLinearVelocity(NAME_root);
 	// 设置 the Last Ragdoll Velocity.
@@ -911,9 +1014,7 @@ void AALSBaseCharacter::RagdollUpdate(float DeltaTime)
 		                      : LastRagdollVelocity / 2;
 
 	/* 使用Ragdoll Velocity来缩放Ragdoll的关节强度的物理动画。 */
-	const float SpringValue = FMath::GetMappedRangeValueClamped({0.0f, 1000.0f}, {0.0f, 25000.0f},
-	                                                            LastRagdollVelocity.Size());
-	GetMesh()->SetAllMotorsAngularDriveParams(SpringValue, 0.0f, 0.0f, false);
+	UpdateRagdollMotorDrive();
 
 	/*
 	 * 如果下落速度超过-4000，则取消重力，防止持续加速。
@@ -924,6 +1025,69 @@ void AALSBaseCharacter::RagdollUpdate(float DeltaTime)
 
 	// 更新 Actor位置以跟踪 ragdoll。
 	SetActorLocationDuringRagdoll(DeltaTime);
+
+	/* 骨盆在地面上保持静止一段时间后，让刚体休眠 */
+	const float PelvisAngularSpeed = GetMesh()->GetPhysicsAngularVelocityInDegrees(NAME_pelvis).Size();
+	if (bRagdollOnGround &&
+		LastRagdollVelocity.SizeSquared() < FMath::Square(RagdollRestLinearSpeed) &&
+		PelvisAngularSpeed < RagdollRestAngularSpeed)
+	{
+		RagdollRestTime += DeltaTime;
+		if (RagdollRestTime >= RagdollRestDelay)
+		{
+			SetRagdollAtRest(true);
+		}
+	}
+	else
+	{
+		RagdollRestTime = 0.0f;
+	}
+}
+
+void AALSBaseCharacter::UpdateRagdollMotorDrive()
+{
+	const float LevelValue = FMath::GetMappedRangeValueClamped({0.0f, 1000.0f}, {0.0f, float(RagdollSpringLevelCount)},
+	                                                           LastRagdollVelocity.Size());
+
+	/* 速度需要越过当前等级的边界再多出滞后量，才切换等级 */
+	if (RagdollSpringLevel != INDEX_NONE &&
+		FMath::Abs(LevelValue - RagdollSpringLevel) <= 0.5f + RagdollSpringHysteresis)
+	{
+		return;
+	}
+
+	const int32 NewLevel = FMath::RoundToInt(LevelValue);
+	if (NewLevel == RagdollSpringLevel)
+	{
+		return;
+	}
+	RagdollSpringLevel = NewLevel;
+
+	const float SpringValue = 25000.0f * RagdollSpringLevel / RagdollSpringLevelCount;
+
+	/* 所有约束使用同一个驱动强度，只在等级变化时更新 */
+	GetMesh()->SetAllMotorsAngularDriveParams(SpringValue, 0.0f, 0.0f, false);
+}
+
+void AALSBaseCharacter::SetRagdollAtRest(bool bNewAtRest)
+{
+	bRagdollAtRest = bNewAtRest;
+	RagdollRestTime = 0.0f;
+
+	if (bNewAtRest)
+	{
+		/* 休眠前忽略发送频率，把最终位置发出去 */
+		if (IsLocallyControlled())
+		{
+			LastRagdollSendTime = -1.0f;
+			SendRagdollLocation();
+		}
+		GetMesh()->PutAllRigidBodiesToSleep();
+	}
+	else
+	{
+		GetMesh()->WakeAllRigidBodies();
+	}
 }
 
 void AALSBaseCharacter::SetActorLocationDuringRagdoll(float DeltaTime)
@@ -932,11 +1096,12 @@ void AALSBaseCharacter::SetActorLocationDuringRagdoll(float DeltaTime)
 	{
 		/* 设置骨盆为目标位置。 */
 		TargetRagdollLocation = GetMesh()->GetSocketLocation(NAME_Pelvis);
-		if (!HasAuthority())
-		{
-			/* 如果不是服务器，就发送到服务器，执行更新actor位置*/
-			Server_SetMeshLocationDuringRagdoll(TargetRagdollLocation);
-		}
+		SendRagdollLocation();
+	}
+	else if (GetLocalRole() == ROLE_SimulatedProxy && RagdollNetBuffer.Num() > 0)
+	{
+		/* 模拟代理在收到的采样之间插值 */
+		TargetRagdollLocation = SampleRagdollLocationBuffer();
 	}
 
 	/* 确定布娃娃是朝上还是朝下，并相应地设置目标旋转。 */
@@ -1016,6 +1181,59 @@ void AALSBaseCharacter::SetActorLocationDuringRagdoll(float DeltaTime)
 	SetActorLocationAndTargetRotation(bRagdollOnGround ? NewRagdollLoc : TargetRagdollLocation, TargetRagdollRotation);
 }
 
+void AALSBaseCharacter::SendRagdollLocation()
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	if (LastRagdollSendTime >= 0.0f && TimeSeconds - LastRagdollSendTime < 1.0f / RagdollNetSendRate)
+	{
+		return;
+	}
+
+	/* 骨盆静止时不再发送 */
+	const bool bAtRest = LastRagdollVelocity.SizeSquared() < FMath::Square(RagdollNetRestSpeed) &&
+		FVector::DistSquared(TargetRagdollLocation, LastSentRagdollLocation) < FMath::Square(RagdollNetRestTolerance);
+	if (bAtRest)
+	{
+		return;
+	}
+
+	LastRagdollSendTime = TimeSeconds;
+	LastSentRagdollLocation = TargetRagdollLocation;
+
+	if (HasAuthority())
+	{
+		RagdollNetLocation = TargetRagdollLocation;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AALSBaseCharacter, RagdollNetLocation, this);
+	}
+	else
+	{
+		/* 如果不是服务器，就发送到服务器，执行更新actor位置*/
+		Server_SetMeshLocationDuringRagdoll(TargetRagdollLocation);
+	}
+}
+
+FVector AALSBaseCharacter::SampleRagdollLocationBuffer() const
+{
+	const float RenderTime = GetWorld()->GetTimeSeconds() - RagdollNetInterpDelay;
+	if (RenderTime <= RagdollNetBuffer[0].Time)
+	{
+		return RagdollNetBuffer[0].Location;
+	}
+
+	for (int32 Index = 1; Index < RagdollNetBuffer.Num(); ++Index)
+	{
+		const FALSRagdollNetSample& From = RagdollNetBuffer[Index - 1];
+		const FALSRagdollNetSample& To = RagdollNetBuffer[Index];
+		if (RenderTime <= To.Time)
+		{
+			const float Alpha = (RenderTime - From.Time) / FMath::Max(To.Time - From.Time, KINDA_SMALL_NUMBER);
+			return FMath::Lerp(From.Location, To.Location, Alpha);
+		}
+	}
+
+	return RagdollNetBuffer.Last().Location;
+}
+
 void AALSBaseCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
 {
 	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
@@ -1305,6 +1523,24 @@ void AALSBaseCharacter::SetEssentialValues(float DeltaTime)
 		ReplicatedCurrentAcceleration = GetCharacterMovement()->GetCurrentAcceleration();
 		ReplicatedControlRotation = GetControlRotation();
 		EasedMaxAcceleration = GetCharacterMovement()->GetMaxAcceleration();
+
+		/* 只有变化超过阈值时才更新复制数据 */
+		if (HasAuthority())
+		{
+			const bool bAimChanged =
+				FMath::Abs(FRotator::NormalizeAxis(ReplicatedControlRotation.Yaw - ReplicatedAimAccel.Yaw)) > AimNetThreshold ||
+				FMath::Abs(FRotator::NormalizeAxis(ReplicatedControlRotation.Pitch - ReplicatedAimAccel.Pitch)) > AimNetThreshold;
+			const bool bAccelChanged =
+				!ReplicatedCurrentAcceleration.Equals(ReplicatedAimAccel.Acceleration, AccelNetThreshold);
+
+			if (bAimChanged || bAccelChanged)
+			{
+				ReplicatedAimAccel.Yaw = ReplicatedControlRotation.Yaw;
+				ReplicatedAimAccel.Pitch = ReplicatedControlRotation.Pitch;
+				ReplicatedAimAccel.Acceleration = ReplicatedCurrentAcceleration;
+				MARK_PROPERTY_DIRTY_FROM_NAME(AALSBaseCharacter, ReplicatedAimAccel, this);
+			}
+		}
 	}
 
 	/*
@@ -1317,6 +1553,24 @@ void AALSBaseCharacter::SetEssentialValues(float DeltaTime)
 		EasedMaxAcceleration = GetCharacterMovement()->GetMaxAcceleration() != 0
 			                       ? GetCharacterMovement()->GetMaxAcceleration()
 			                       : EasedMaxAcceleration / 2;
+
+		/*
+		 * 在两次复制之间按角速度外推瞄准方向，加速度平滑过渡。
+		 * 转动停止后变化低于阈值，服务器不会再发送，超过预期的间隔没收到新采样就停止外推，
+		 * 回到最后一次采样，避免一直停在外推过头的方向上。
+		 */
+		const float ElapsedTime = GetWorld()->GetTimeSeconds() - AimNetReceiveTime;
+		if (AimNetReceiveTime >= 0.0f && ElapsedTime > AimNetSettleTime)
+		{
+			AimNetAngularRate = FVector2D::ZeroVector;
+		}
+		const float ExtrapolationTime = AimNetReceiveTime >= 0.0f
+			                                ? FMath::Min(ElapsedTime, AimNetMaxExtrapolation)
+			                                : 0.0f;
+		ReplicatedControlRotation = FRotator(ReplicatedAimAccel.Pitch + AimNetAngularRate.Y * ExtrapolationTime,
+		                                     ReplicatedAimAccel.Yaw + AimNetAngularRate.X * ExtrapolationTime, 0.0f);
+		ReplicatedCurrentAcceleration = FMath::VInterpTo(ReplicatedCurrentAcceleration,
+		                                                 ReplicatedAimAccel.Acceleration, DeltaTime, 15.0f);
 	}
 
 	// 让当前值到目标值有一个光滑的过渡
@@ -1911,20 +2165,112 @@ void AALSBaseCharacter::ReplicatedRagdollEnd()
 	}
 }
 
-void AALSBaseCharacter::OnRep_RotationMode(EALSRotationMode PrevRotMode)
+void AALSBaseCharacter::ApplyMoveLocomotionState(const FALSReplicatedLocomotionState& NewState,
+                                                 const FALSReplicatedLocomotionState& PrevState)
+{
+	/* 服务器端自己修改过的状态不会被客户端旧的值覆盖 */
+	if (NewState.DesiredGait != PrevState.DesiredGait)
+	{
+		SetDesiredGait(NewState.DesiredGait);
+	}
+	if (NewState.DesiredStance != PrevState.DesiredStance)
+	{
+		SetDesiredStance(NewState.DesiredStance);
+	}
+	if (NewState.DesiredRotationMode != PrevState.DesiredRotationMode)
+	{
+		SetDesiredRotationMode(NewState.DesiredRotationMode);
+	}
+	if (NewState.RotationMode != PrevState.RotationMode)
+	{
+		SetRotationMode(NewState.RotationMode);
+	}
+	if (NewState.ViewMode != PrevState.ViewMode)
+	{
+		SetViewMode(NewState.ViewMode);
+	}
+	if (NewState.OverlayState != PrevState.OverlayState)
+	{
+		SetOverlayState(NewState.OverlayState);
+	}
+}
+
+void AALSBaseCharacter::SetReplayDesiredState(EALSGait NewDesiredGait, EALSStance NewDesiredStance)
 {
-	OnRotationModeChanged(PrevRotMode);
+	DesiredGait = NewDesiredGait;
+	DesiredStance = NewDesiredStance;
 }
 
-void AALSBaseCharacter::OnRep_ViewMode(EALSViewMode PrevViewMode)
+void AALSBaseCharacter::UpdateReplicatedLocomotionState()
 {
-	OnViewModeChanged(PrevViewMode);
+	/* 模拟代理只接收状态 */
+	if (GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		return;
+	}
+
+	FALSReplicatedLocomotionState NewState;
+	NewState.DesiredGait = DesiredGait;
+	NewState.DesiredStance = DesiredStance;
+	NewState.DesiredRotationMode = DesiredRotationMode;
+	NewState.RotationMode = RotationMode;
+	NewState.ViewMode = ViewMode;
+	NewState.OverlayState = OverlayState;
+
+	if (NewState != ReplicatedLocomotionState)
+	{
+		ReplicatedLocomotionState = NewState;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AALSBaseCharacter, ReplicatedLocomotionState, this);
+	}
 }
 
-/* 当 @OverlayState 变量发生改变的时候调用 */
-void AALSBaseCharacter::OnRep_OverlayState(EALSOverlayState PrevOverlayState)
+void AALSBaseCharacter::OnRep_AimAccel(const FALSReplicatedAimAccel& PrevAimAccel)
 {
-	OnOverlayStateChanged(PrevOverlayState);
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	const float DeltaReceive = TimeSeconds - AimNetReceiveTime;
+
+	/* 两次采样间隔太长时不再外推，避免转身过头 */
+	if (AimNetReceiveTime >= 0.0f && DeltaReceive > KINDA_SMALL_NUMBER && DeltaReceive < 0.5f)
+	{
+		AimNetAngularRate.X = FRotator::NormalizeAxis(ReplicatedAimAccel.Yaw - PrevAimAccel.Yaw) / DeltaReceive;
+		AimNetAngularRate.Y = FRotator::NormalizeAxis(ReplicatedAimAccel.Pitch - PrevAimAccel.Pitch) / DeltaReceive;
+		/* 持续转动时下一次采样应当在相近的间隔内到达 */
+		AimNetSettleTime = DeltaReceive * 1.5f;
+	}
+	else
+	{
+		AimNetAngularRate = FVector2D::ZeroVector;
+	}
+	AimNetReceiveTime = TimeSeconds;
+}
+
+/* 先一次性写入所有状态，再分发发生变化的事件 */
+void AALSBaseCharacter::OnRep_LocomotionState()
+{
+	const FALSReplicatedLocomotionState& State = ReplicatedLocomotionState;
+	const EALSRotationMode PrevRotationMode = RotationMode;
+	const EALSViewMode PrevViewMode = ViewMode;
+	const EALSOverlayState PrevOverlayState = OverlayState;
+
+	DesiredGait = State.DesiredGait;
+	DesiredStance = State.DesiredStance;
+	DesiredRotationMode = State.DesiredRotationMode;
+	RotationMode = State.RotationMode;
+	ViewMode = State.ViewMode;
+	OverlayState = State.OverlayState;
+
+	if (PrevOverlayState != OverlayState)
+	{
+		OnOverlayStateChanged(PrevOverlayState);
+	}
+	if (PrevRotationMode != RotationMode)
+	{
+		OnRotationModeChanged(PrevRotationMode);
+	}
+	if (PrevViewMode != ViewMode)
+	{
+		OnViewModeChanged(PrevViewMode);
+	}
 }
 
 void AALSBaseCharacter::OnRep_VisibleMesh(USkeletalMesh* NewVisibleMesh)
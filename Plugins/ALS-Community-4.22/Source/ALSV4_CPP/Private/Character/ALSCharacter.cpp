@@ -33,9 +33,9 @@ AALSCharacter::AALSCharacter(const FObjectInitializer& ObjectInitializer)
  */
 void AALSCharacter::ClearHeldObject()
 {
-	StaticMesh->SetStaticMesh(nullptr);
-	SkeletalMesh->SetSkeletalMesh(nullptr);
-	SkeletalMesh->SetAnimInstanceClass(nullptr);
+	// 只隐藏，模型和动画实例留在缓存中
+	SetHeldComponentActive(StaticMesh, false);
+	SetHeldComponentActive(SkeletalMesh, false);
 	if (MainAnimInstance)
 	{
 		MainAnimInstance->LastOverlayState = OverlayState;
@@ -50,18 +50,16 @@ void AALSCharacter::AttachToHand(UStaticMesh* NewStaticMesh, USkeletalMesh* NewS
 {
 	ClearHeldObject();
 
-	// 设置对应的变量
+	// 设置对应的变量，优先使用缓存中已经设置好的组件
 	if (IsValid(NewStaticMesh))
 	{
-		StaticMesh->SetStaticMesh(NewStaticMesh);
+		StaticMesh = FindOrAddHeldStaticMesh(NewStaticMesh);
+		SetHeldComponentActive(StaticMesh, true);
 	}
 	else if (IsValid(NewSkeletalMesh))
 	{
-		SkeletalMesh->SetSkeletalMesh(NewSkeletalMesh);
-		if (IsValid(NewAnimClass))
-		{
-			SkeletalMesh->SetAnimInstanceClass(NewAnimClass);
-		}
+		SkeletalMesh = FindOrAddHeldSkeletalMesh(NewSkeletalMesh, IsValid(NewAnimClass) ? NewAnimClass : nullptr);
+		SetHeldComponentActive(SkeletalMesh, true);
 	}
 
 	// FName AttachBone;
@@ -74,11 +72,119 @@ void AALSCharacter::AttachToHand(UStaticMesh* NewStaticMesh, USkeletalMesh* NewS
 	// 	AttachBone = TEXT("VB RHS_ik_hand_gun");
 	// }
 
-	HeldObjectRoot->AttachToComponent(GetMesh(),
-	                                  FAttachmentTransformRules::SnapToTargetNotIncludingScale, AttachBone);
+	if (HeldObjectRoot->GetAttachParent() != GetMesh() || HeldObjectAttachBone != AttachBone)
+	{
+		HeldObjectRoot->AttachToComponent(GetMesh(),
+		                                  FAttachmentTransformRules::SnapToTargetNotIncludingScale, AttachBone);
+		HeldObjectAttachBone = AttachBone;
+	}
 	HeldObjectRoot->SetRelativeLocation(Offset);
 }
 
+USkeletalMeshComponent* AALSCharacter::FindOrAddHeldSkeletalMesh(USkeletalMesh* NewSkeletalMesh, UClass* NewAnimClass)
+{
+	// 构造时创建的组件作为第一个缓存
+	if (HeldSkeletalMeshCache.Num() == 0)
+	{
+		HeldSkeletalMeshCache.Add(SkeletalMesh);
+	}
+
+	USkeletalMeshComponent* Component = nullptr;
+	for (int32 Index = 0; Index < HeldSkeletalMeshCache.Num(); ++Index)
+	{
+		USkeletalMeshComponent* Cached = HeldSkeletalMeshCache[Index];
+		if (Cached->SkeletalMesh == NewSkeletalMesh && Cached->AnimClass == NewAnimClass)
+		{
+			// 移到末尾，数组开头就是最久没有使用的
+			HeldSkeletalMeshCache.RemoveAt(Index, 1, false);
+			HeldSkeletalMeshCache.Add(Cached);
+			return Cached;
+		}
+
+		if (!Component && !Cached->SkeletalMesh)
+		{
+			Component = Cached;
+		}
+	}
+
+	if (!Component)
+	{
+		if (HeldSkeletalMeshCache.Num() < MaxHeldObjectCacheSize)
+		{
+			// 以第一个组件为模板，保持碰撞、阴影等设置一致
+			Component = NewObject<USkeletalMeshComponent>(this, NAME_None, RF_Transient, HeldSkeletalMeshCache[0]);
+			Component->SetupAttachment(HeldObjectRoot);
+			Component->RegisterComponent();
+			HeldSkeletalMeshCache.Add(Component);
+		}
+		else
+		{
+			Component = HeldSkeletalMeshCache[0];
+		}
+	}
+
+	// 只有第一次使用这个模型时才需要设置模型和动画实例
+	HeldSkeletalMeshCache.Remove(Component);
+	HeldSkeletalMeshCache.Add(Component);
+	Component->SetSkeletalMesh(NewSkeletalMesh);
+	Component->SetAnimInstanceClass(NewAnimClass);
+	return Component;
+}
+
+UStaticMeshComponent* AALSCharacter::FindOrAddHeldStaticMesh(UStaticMesh* NewStaticMesh)
+{
+	if (HeldStaticMeshCache.Num() == 0)
+	{
+		HeldStaticMeshCache.Add(StaticMesh);
+	}
+
+	UStaticMeshComponent* Component = nullptr;
+	for (int32 Index = 0; Index < HeldStaticMeshCache.Num(); ++Index)
+	{
+		UStaticMeshComponent* Cached = HeldStaticMeshCache[Index];
+		if (Cached->GetStaticMesh() == NewStaticMesh)
+		{
+			HeldStaticMeshCache.RemoveAt(Index, 1, false);
+			HeldStaticMeshCache.Add(Cached);
+			return Cached;
+		}
+
+		if (!Component && !Cached->GetStaticMesh())
+		{
+			Component = Cached;
+		}
+	}
+
+	if (!Component)
+	{
+		if (HeldStaticMeshCache.Num() < MaxHeldObjectCacheSize)
+		{
+			Component = NewObject<UStaticMeshComponent>(this, NAME_None, RF_Transient, HeldStaticMeshCache[0]);
+			Component->SetupAttachment(HeldObjectRoot);
+			Component->RegisterComponent();
+			HeldStaticMeshCache.Add(Component);
+		}
+		else
+		{
+			Component = HeldStaticMeshCache[0];
+		}
+	}
+
+	HeldStaticMeshCache.Remove(Component);
+	HeldStaticMeshCache.Add(Component);
+	Component->SetStaticMesh(NewStaticMesh);
+	return Component;
+}
+
+void AALSCharacter::SetHeldComponentActive(UPrimitiveComponent* Component, bool bActive)
+{
+	if (Component)
+	{
+		Component->SetVisibility(bActive);
+		Component->SetComponentTickEnabled(bActive);
+	}
+}
+
 void AALSCharacter::RagdollStart()
 {
 	// 添加了举起物体的功能，所以首先先将物体进行清楚，然后再开始洋娃娃。
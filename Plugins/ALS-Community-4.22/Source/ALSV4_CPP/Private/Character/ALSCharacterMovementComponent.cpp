@@ -14,6 +14,11 @@
 UALSCharacterMovementComponent::UALSCharacterMovementComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	bLastMoveCanInputMove = false;
+	bLastMoveDesiredLaddering = false;
+	bHasLastMoveState = false;
+
+	SetNetworkMoveDataContainer(ALSNetworkMoveDataContainer);
 }
 
 /*
@@ -42,6 +47,34 @@ void UALSCharacterMovementComponent::OnMovementUpdated(float DeltaTime, const FV
 	}
 }
 
+/*
+ * 和引擎处理 bPressedJump、bWantsToCrouch 的方式一样，重放前记下真实的状态，重放后恢复
+ */
+bool UALSCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	AALSBaseCharacter* ALSCharacter = Cast<AALSBaseCharacter>(CharacterOwner);
+
+	const EALSGait RealAllowedGait = AllowedGait;
+	const uint8 bRealRequestMovementSettingsChange = bRequestMovementSettingsChange;
+	const float RealMaxWalkSpeed = MaxWalkSpeed;
+	const float RealMaxWalkSpeedCrouched = MaxWalkSpeedCrouched;
+	const EALSGait RealDesiredGait = ALSCharacter ? ALSCharacter->GetDesiredGait() : EALSGait::Walking;
+	const EALSStance RealDesiredStance = ALSCharacter ? ALSCharacter->GetDesiredStance() : EALSStance::Standing;
+
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	AllowedGait = RealAllowedGait;
+	bRequestMovementSettingsChange = bRealRequestMovementSettingsChange;
+	MaxWalkSpeed = RealMaxWalkSpeed;
+	MaxWalkSpeedCrouched = RealMaxWalkSpeedCrouched;
+	if (ALSCharacter)
+	{
+		ALSCharacter->SetReplayDesiredState(RealDesiredGait, RealDesiredStance);
+	}
+
+	return bResult;
+}
+
 /*
  * 模拟走路的物理属性
  * 主要是更新摩擦力，让运动控制的更加细致。
@@ -95,6 +128,50 @@ void UALSCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags) // C
 	bRequestMovementSettingsChange = Flags & FSavedMove_Character::FLAG_Custom_0;
 }
 
+/*
+ * 服务器执行客户端的移动之前，先按移动顺序应用客户端的期望状态
+ */
+void UALSCharacterMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags,
+                                                    const FVector& NewAccel)
+{
+	const FALSCharacterNetworkMoveData* MoveData = static_cast<const FALSCharacterNetworkMoveData*>(
+		GetCurrentNetworkMoveData());
+	AALSBaseCharacter* ALSCharacter = Cast<AALSBaseCharacter>(CharacterOwner);
+
+	if (MoveData && ALSCharacter)
+	{
+		AllowedGait = MoveData->AllowedGait;
+
+		const bool bCanInputMove = (CompressedFlags & FSavedMove_Character::FLAG_Custom_1) != 0;
+		const bool bDesiredLaddering = (CompressedFlags & FSavedMove_Character::FLAG_Custom_2) != 0;
+
+		/* 第一次收到时，以服务器当前的状态作为比较基准 */
+		if (!bHasLastMoveState)
+		{
+			LastMoveLocomotionState = ALSCharacter->GetLocomotionState();
+			bLastMoveCanInputMove = ALSCharacter->GetCanInputMove();
+			bLastMoveDesiredLaddering = ALSCharacter->GetDesiredLaddering();
+			bHasLastMoveState = true;
+		}
+
+		ALSCharacter->ApplyMoveLocomotionState(MoveData->LocomotionState, LastMoveLocomotionState);
+		if (bCanInputMove != bLastMoveCanInputMove)
+		{
+			ALSCharacter->SetCanInputMove(bCanInputMove);
+		}
+		if (bDesiredLaddering != bLastMoveDesiredLaddering)
+		{
+			ALSCharacter->SetDesiredLaddering(bDesiredLaddering);
+		}
+
+		LastMoveLocomotionState = MoveData->LocomotionState;
+		bLastMoveCanInputMove = bCanInputMove;
+		bLastMoveDesiredLaddering = bDesiredLaddering;
+	}
+
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+}
+
 /*
  * 将自定义的结构体内容传入其中
  */
@@ -127,6 +204,9 @@ void UALSCharacterMovementComponent::FSavedMove_My::Clear()
 
 	bSavedRequestMovementSettingsChange = false;
 	SavedAllowedGait = EALSGait::Walking;
+	bSavedCanInputMove = false;
+	bSavedDesiredLaddering = false;
+	SavedLocomotionState = FALSReplicatedLocomotionState();
 }
 
 /*
@@ -142,6 +222,16 @@ uint8 UALSCharacterMovementComponent::FSavedMove_My::GetCompressedFlags() const
 		Result |= FLAG_Custom_0;
 	}
 
+	if (bSavedCanInputMove)
+	{
+		Result |= FLAG_Custom_1;
+	}
+
+	if (bSavedDesiredLaddering)
+	{
+		Result |= FLAG_Custom_2;
+	}
+
 	return Result;
 }
 
@@ -162,6 +252,14 @@ void UALSCharacterMovementComponent::FSavedMove_My::SetMoveFor(ACharacter* Chara
 		bSavedRequestMovementSettingsChange = CharacterMovement->bRequestMovementSettingsChange;
 		SavedAllowedGait = CharacterMovement->AllowedGait;
 	}
+
+	AALSBaseCharacter* ALSCharacter = Cast<AALSBaseCharacter>(Character);
+	if (ALSCharacter)
+	{
+		bSavedCanInputMove = ALSCharacter->GetCanInputMove();
+		bSavedDesiredLaddering = ALSCharacter->GetDesiredLaddering();
+		SavedLocomotionState = ALSCharacter->GetLocomotionState();
+	}
 }
 
 /*
@@ -176,7 +274,38 @@ void UALSCharacterMovementComponent::FSavedMove_My::PrepMoveFor(ACharacter* Char
 	if (CharacterMovement)
 	{
 		CharacterMovement->AllowedGait = SavedAllowedGait;
+		CharacterMovement->bRequestMovementSettingsChange = bSavedRequestMovementSettingsChange;
 	}
+
+	/*
+	 * 重放时只写入移动会读取的步态和姿态，不调用会触发回调的 Set 函数（视角、覆盖状态、换武器等）。
+	 * 重放结束后由 ClientUpdatePositionAfterServerUpdate 恢复真实的状态
+	 */
+	AALSBaseCharacter* ALSCharacter = Cast<AALSBaseCharacter>(Character);
+	if (ALSCharacter)
+	{
+		ALSCharacter->SetReplayDesiredState(SavedLocomotionState.DesiredGait, SavedLocomotionState.DesiredStance);
+	}
+}
+
+/*
+ * 只有 ALS 的自定义状态完全相同时才允许合并移动，否则状态变化会在合并中丢失
+ */
+bool UALSCharacterMovementComponent::FSavedMove_My::CanCombineWith(const FSavedMovePtr& NewMove,
+                                                                   ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_My* NewMyMove = static_cast<const FSavedMove_My*>(NewMove.Get());
+
+	if (bSavedRequestMovementSettingsChange != NewMyMove->bSavedRequestMovementSettingsChange ||
+		SavedAllowedGait != NewMyMove->SavedAllowedGait ||
+		bSavedCanInputMove != NewMyMove->bSavedCanInputMove ||
+		bSavedDesiredLaddering != NewMyMove->bSavedDesiredLaddering ||
+		SavedLocomotionState != NewMyMove->SavedLocomotionState)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
 }
 
 UALSCharacterMovementComponent::FNetworkPredictionData_Client_My::FNetworkPredictionData_Client_My(
@@ -191,11 +320,41 @@ FSavedMovePtr UALSCharacterMovementComponent::FNetworkPredictionData_Client_My::
 }
 
 /*
- * 服务器更新运动步态
+ * 把保存的移动中的自定义状态写入要发送的移动数据
  */
-void UALSCharacterMovementComponent::Server_SetAllowedGait_Implementation(const EALSGait NewAllowedGait)
+void UALSCharacterMovementComponent::FALSCharacterNetworkMoveData::ClientFillNetworkMoveData(
+	const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
 {
-	AllowedGait = NewAllowedGait;
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	const FSavedMove_My& SavedMove = static_cast<const FSavedMove_My&>(ClientMove);
+	LocomotionState = SavedMove.SavedLocomotionState;
+	AllowedGait = SavedMove.SavedAllowedGait;
+}
+
+bool UALSCharacterMovementComponent::FALSCharacterNetworkMoveData::Serialize(
+	UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	bool bLocalSuccess = true;
+	LocomotionState.NetSerialize(Ar, PackageMap, bLocalSuccess);
+
+	uint32 PackedGait = static_cast<uint32>(AllowedGait);
+	Ar.SerializeBits(&PackedGait, 2);
+	if (Ar.IsLoading())
+	{
+		AllowedGait = static_cast<EALSGait>(FMath::Min<uint32>(PackedGait, static_cast<uint32>(EALSGait::Sprinting)));
+	}
+
+	return !Ar.IsError();
+}
+
+UALSCharacterMovementComponent::FALSCharacterNetworkMoveDataContainer::FALSCharacterNetworkMoveDataContainer()
+{
+	NewMoveData = &CustomDefaultMoveData[0];
+	PendingMoveData = &CustomDefaultMoveData[1];
+	OldMoveData = &CustomDefaultMoveData[2];
 }
 
 /*
@@ -247,13 +406,8 @@ void UALSCharacterMovementComponent::SetAllowedGait(EALSGait NewAllowedGait)
 	/* 判断是否是由本地操作者操作 */
 	if (PawnOwner->IsLocallyControlled())
 	{
+		/* 联机状态下，允许的步态会随保存的移动一起发送给服务器 */
 		AllowedGait = NewAllowedGait;
-		/* 如果是联机状态，并且是真人操作，就将当前的操作传递给服务器进行更新 */
-		if (GetCharacterOwner()->GetLocalRole() == ROLE_AutonomousProxy)
-		{
-			// client -> server 
-			Server_SetAllowedGait(NewAllowedGait);
-		}
 		/* 状态已经更新 */
 		bRequestMovementSettingsChange = true;
 		
@@ -269,3 +423,8 @@ void UALSCharacterMovementComponent::SetAllowedGait(EALSGait NewAllowedGait)
 		MaxWalkSpeedCrouched = UpdateMaxWalkSpeed;
 	}
 }
+
+void UALSCharacterMovementComponent::Server_SetAllowedGait(EALSGait NewAllowedGait)
+{
+	SetAllowedGait(NewAllowedGait);
+}
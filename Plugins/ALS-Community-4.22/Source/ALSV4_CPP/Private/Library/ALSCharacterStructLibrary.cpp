@@ -0,0 +1,64 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Copyright:       Copyright (C) 2021 Doğa Can Yanıkoğlu
+// License:         MIT License (http://www.opensource.org/licenses/mit-license.php)
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Library/ALSCharacterStructLibrary.h"
+
+#include "Engine/NetSerialization.h"
+
+bool FALSReplicatedLocomotionState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	/* 位布局: DesiredGait(2) DesiredStance(1) DesiredRotationMode(2) RotationMode(2) ViewMode(1) OverlayState(4) */
+	uint32 Packed = 0;
+	if (Ar.IsSaving())
+	{
+		Packed = static_cast<uint32>(DesiredGait) |
+			static_cast<uint32>(DesiredStance) << 2 |
+			static_cast<uint32>(DesiredRotationMode) << 3 |
+			static_cast<uint32>(RotationMode) << 5 |
+			static_cast<uint32>(ViewMode) << 7 |
+			static_cast<uint32>(OverlayState) << 8;
+	}
+
+	Ar.SerializeBits(&Packed, 12);
+
+	if (Ar.IsLoading())
+	{
+		DesiredGait = static_cast<EALSGait>(Packed & 0x3);
+		DesiredStance = static_cast<EALSStance>(Packed >> 2 & 0x1);
+		DesiredRotationMode = static_cast<EALSRotationMode>(Packed >> 3 & 0x3);
+		RotationMode = static_cast<EALSRotationMode>(Packed >> 5 & 0x3);
+		ViewMode = static_cast<EALSViewMode>(Packed >> 7 & 0x1);
+		OverlayState = static_cast<EALSOverlayState>(Packed >> 8 & 0xF);
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+bool FALSReplicatedAimAccel::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 PackedYaw = 0;
+	uint32 PackedPitch = 0;
+	if (Ar.IsSaving())
+	{
+		PackedYaw = FMath::RoundToInt(FRotator::ClampAxis(Yaw) * (4096.0f / 360.0f)) & 0xFFF;
+		PackedPitch = FMath::RoundToInt(FRotator::ClampAxis(Pitch) * (4096.0f / 360.0f)) & 0xFFF;
+	}
+
+	Ar.SerializeBits(&PackedYaw, 12);
+	Ar.SerializeBits(&PackedPitch, 12);
+
+	if (Ar.IsLoading())
+	{
+		Yaw = FRotator::NormalizeAxis(PackedYaw * (360.0f / 4096.0f));
+		Pitch = FRotator::NormalizeAxis(PackedPitch * (360.0f / 4096.0f));
+	}
+
+	bOutSuccess = SerializePackedVector<1, 20>(Acceleration, Ar);
+	return true;
+}
@@ -0,0 +1,37 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Copyright:       Copyright (C) 2021 Doğa Can Yanıkoğlu
+// License:         MIT License (http://www.opensource.org/licenses/mit-license.php)
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Library/ALSMontageRegistry.h"
+
+#include "Animation/AnimMontage.h"
+
+uint8 UALSMontageRegistry::FindMontageId(const UAnimMontage* Montage) const
+{
+	if (!Montage)
+	{
+		return 0;
+	}
+
+	const int32 Index = Montages.IndexOfByKey(Montage);
+	return Index != INDEX_NONE && Index < MAX_uint8 ? static_cast<uint8>(Index + 1) : 0;
+}
+
+UAnimMontage* UALSMontageRegistry::GetMontageById(uint8 MontageId) const
+{
+	return MontageId > 0 && Montages.IsValidIndex(MontageId - 1) ? Montages[MontageId - 1] : nullptr;
+}
+
+uint8 UALSMontageRegistry::PackPlayRate(float PlayRate)
+{
+	return static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(PlayRate * 64.0f), 1, 255));
+}
+
+float UALSMontageRegistry::UnpackPlayRate(uint8 PackedPlayRate)
+{
+	return PackedPlayRate / 64.0f;
+}
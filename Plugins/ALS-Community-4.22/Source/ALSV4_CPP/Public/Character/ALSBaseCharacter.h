@@ -19,6 +19,7 @@
 
 // 函数前置声明
 class UALSDebugComponent;
+class UALSMontageRegistry;
 class UTimelineComponent;
 class UAnimInstance;
 class UAnimMontage;
@@ -78,8 +79,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ALS|Ragdoll System")
 	virtual void RagdollEnd();
 
-	UFUNCTION(BlueprintCallable, Server, Unreliable, Category = "ALS|Ragdoll System")
-	void Server_SetMeshLocationDuringRagdoll(FVector MeshLocation);
+	UFUNCTION(Server, Unreliable, Category = "ALS|Ragdoll System")
+	void Server_SetMeshLocationDuringRagdoll(FVector_NetQuantize10 MeshLocation);
 
 	/** Character States */
 
@@ -116,7 +117,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void SetRotationMode(EALSRotationMode NewRotationMode, bool bForce = false);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void Server_SetRotationMode(EALSRotationMode NewRotationMode, bool bForce);
 
 	UFUNCTION(BlueprintGetter, Category = "ALS|Character States")
@@ -125,22 +127,28 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void SetViewMode(EALSViewMode NewViewMode, bool bForce = false);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void Server_SetViewMode(EALSViewMode NewViewMode, bool bForce);
 
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void SetCanInputMove(bool NewState, bool bForce = false);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void Server_SetCanInputMove(bool NewState, bool bForce);
 
+	UFUNCTION(BlueprintGetter, Category = "ALS|Character States")
+	bool GetCanInputMove() const { return bCanInputMove; }
+
 	UFUNCTION(BlueprintGetter, Category = "ALS|Character States")
 	EALSViewMode GetViewMode() const { return ViewMode; }
 
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void SetOverlayState(EALSOverlayState NewState, bool bForce = false);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void Server_SetOverlayState(EALSOverlayState NewState, bool bForce);
 
 	UFUNCTION(BlueprintGetter, Category = "ALS|Character States")
@@ -171,12 +179,20 @@ public:
 
 	
 	/** Rolling Montage Play Replication*/
+	/* 不在 MontageRegistry 中（或者没有设置 MontageRegistry）的蒙太奇按对象引用同步 */
 	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
 	void Server_PlayMontage(UAnimMontage* Montage, float PlayRate);
 
 	UFUNCTION(BlueprintCallable, NetMulticast, Reliable, Category = "ALS|Character States")
 	void Multicast_PlayMontage(UAnimMontage* Montage, float PlayRate);
 
+	/* 只传输 MontageRegistry 中的编号和量化后的播放速率 */
+	UFUNCTION(Server, Reliable, Category = "ALS|Character States")
+	void Server_PlayMontageById(uint8 MontageId, uint8 PackedPlayRate);
+
+	UFUNCTION(NetMulticast, Unreliable, Category = "ALS|Character States")
+	void Multicast_PlayMontageById(uint8 MontageId, uint8 PackedPlayRate);
+
 	/** Ragdolling*/
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void ReplicatedRagdollStart();
@@ -225,13 +241,15 @@ public:
 	UFUNCTION(BlueprintSetter, Category = "ALS|Input")
 	void SetDesiredStance(EALSStance NewStance);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Input")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Input")
 	void Server_SetDesiredStance(EALSStance NewStance);
 
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void SetDesiredGait(EALSGait NewGait);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void Server_SetDesiredGait(EALSGait NewGait);
 
 	UFUNCTION(BlueprintGetter, Category = "ALS|Input")
@@ -240,7 +258,8 @@ public:
 	UFUNCTION(BlueprintSetter, Category = "ALS|Input")
 	void SetDesiredRotationMode(EALSRotationMode NewRotMode);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void Server_SetDesiredRotationMode(EALSRotationMode NewRotMode);
 
 	UFUNCTION(BlueprintCallable, Category = "ALS|Input")
@@ -294,9 +313,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ALS|Climbing System")
 	void SetDesiredLaddering(bool NewState);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Climbing System")
+	/* 兼容旧的蓝图调用，状态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Climbing System")
 	void Server_SetDesiredLaddering(bool NewState);
 
+	UFUNCTION(BlueprintGetter, Category = "ALS|Climbing System")
+	bool GetDesiredLaddering() const { return bDesiredLaddering; }
+
+	/** Saved Moves */
+
+	/* 当前的运动状态，由客户端写入保存的移动中发送给服务器 */
+	const FALSReplicatedLocomotionState& GetLocomotionState() const { return ReplicatedLocomotionState; }
+
+	/* 服务器按移动顺序应用客户端发来的状态，只应用和上一次移动相比有变化的部分 */
+	void ApplyMoveLocomotionState(const FALSReplicatedLocomotionState& NewState,
+	                              const FALSReplicatedLocomotionState& PrevState);
+
+	/* 客户端重放移动时直接写入期望的步态和姿态，不触发任何状态改变的回调 */
+	void SetReplayDesiredState(EALSGait NewDesiredGait, EALSStance NewDesiredStance);
+
 	UFUNCTION(BlueprintCallable, Category = "ALS|Climbing System")
 	void SetRotateInClimbAngle(float Angle);
 
@@ -400,6 +435,21 @@ protected:
 
 	void SetActorLocationDuringRagdoll(float DeltaTime);
 
+	/* 根据速度计算关节强度等级，只有等级改变时才写入物理约束 */
+	void UpdateRagdollMotorDrive();
+
+	/* 进入或离开静止状态，静止时刚体休眠 */
+	void SetRagdollAtRest(bool bNewAtRest);
+
+	/* 按固定频率发送量化后的骨盆位置，静止时不发送 */
+	void SendRagdollLocation();
+
+	/* 从插值缓冲中取出当前应该使用的骨盆位置 */
+	FVector SampleRagdollLocationBuffer() const;
+
+	UFUNCTION()
+	void OnRep_RagdollNetLocation();
+
 	/** State Changes */
 	
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|State Values")
@@ -494,13 +544,23 @@ protected:
 
 	/** Replication */
 	UFUNCTION(Category = "ALS|Replication")
-	void OnRep_RotationMode(EALSRotationMode PrevRotMode);
+	void OnRep_AimAccel(const FALSReplicatedAimAccel& PrevAimAccel);
 
 	UFUNCTION(Category = "ALS|Replication")
-	void OnRep_ViewMode(EALSViewMode PrevViewMode);
+	void OnRep_CurrentMontage();
+
+	/* 服务器记录当前蒙太奇并通知模拟代理播放 */
+	void BroadcastMontage(uint8 MontageId, uint8 PackedPlayRate);
 
+	/* 模拟代理播放蒙太奇，已经在播放时忽略 */
+	void PlayReplicatedMontage(UAnimMontage* Montage, float PlayRate, float StartPosition = 0.0f);
+
+	/* 和上一次的状态比较，分发对应的 On*Changed 事件 */
 	UFUNCTION(Category = "ALS|Replication")
-	void OnRep_OverlayState(EALSOverlayState PrevOverlayState);
+	void OnRep_LocomotionState();
+
+	/* 把当前的运动状态写入 ReplicatedLocomotionState，有变化时标记为脏 */
+	void UpdateReplicatedLocomotionState();
 
 	UFUNCTION(Category = "ALS|Replication")
 	void OnRep_VisibleMesh(USkeletalMesh* NewVisibleMesh);
@@ -512,13 +572,13 @@ protected:
 
 	/** Input */
 
-	UPROPERTY(EditAnywhere, Replicated, BlueprintReadWrite, Category = "ALS|Input")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS|Input")
 	EALSRotationMode DesiredRotationMode = EALSRotationMode::LookingDirection;
 
-	UPROPERTY(EditAnywhere, Replicated, BlueprintReadWrite, Category = "ALS|Input")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS|Input")
 	EALSGait DesiredGait = EALSGait::Running;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "ALS|Input")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS|Input")
 	EALSStance DesiredStance = EALSStance::Standing;
 
 	/* 向上向下看的移动速率 */
@@ -601,11 +661,19 @@ protected:
 	/** State Values */
 
 	/* 覆盖状态 */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|State Values", ReplicatedUsing = OnRep_OverlayState)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|State Values")
 	EALSOverlayState OverlayState = EALSOverlayState::Default;
 
 	/** Movement System */
 
+	/* 加入这个列表的蒙太奇按编号同步，并且后加入的客户端也能补播，比如翻滚 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ALS|Movement System")
+	UALSMontageRegistry* MontageRegistry = nullptr;
+
+	/* 服务器上最近一次播放的蒙太奇，后加入的客户端通过它补播 */
+	UPROPERTY(ReplicatedUsing = OnRep_CurrentMontage)
+	FALSReplicatedMontage CurrentMontage;
+
 	/* 储存运动数据表的变量 */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ALS|Movement System")
 	FDataTableRowHandle MovementModel;
@@ -645,13 +713,37 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|Essential Information")
 	float EasedMaxAcceleration = 0.0f;
 
-	/* 目前角色的加速度 */
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Essential Information")
+	/* 目前角色的加速度，模拟代理上由 ReplicatedAimAccel 还原 */
+	UPROPERTY(BlueprintReadOnly, Category = "ALS|Essential Information")
 	FVector ReplicatedCurrentAcceleration = FVector::ZeroVector;
 
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Essential Information")
+	UPROPERTY(BlueprintReadOnly, Category = "ALS|Essential Information")
 	FRotator ReplicatedControlRotation = FRotator::ZeroRotator;
 
+	/* 量化后的瞄准方向和加速度，变化超过阈值时才更新 */
+	UPROPERTY(ReplicatedUsing = OnRep_AimAccel)
+	FALSReplicatedAimAccel ReplicatedAimAccel;
+
+	/* 瞄准方向变化超过这个角度（度）才进行复制 */
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Essential Information")
+	float AimNetThreshold = 0.1f;
+
+	/* 加速度变化超过这个值才进行复制 */
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Essential Information")
+	float AccelNetThreshold = 20.0f;
+
+	/* 模拟代理最多向前外推的时间 */
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Essential Information")
+	float AimNetMaxExtrapolation = 0.1f;
+
+	/* 模拟代理根据最近两次采样计算出的 Yaw、Pitch 角速度 */
+	FVector2D AimNetAngularRate = FVector2D::ZeroVector;
+
+	float AimNetReceiveTime = -1.0f;
+
+	/* 超过这个时间没有收到新采样，认为转动已经停止，不再外推 */
+	float AimNetSettleTime = 0.0f;
+
 	/** Replicated Skeletal Mesh Information*/
 	/* 替换角色网格体的时候会调用, 保存的是当前 新设置的 mesh  */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Skeletal Mesh", ReplicatedUsing = OnRep_VisibleMesh)
@@ -668,7 +760,7 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|State Values")
 	EALSMovementAction MovementAction = EALSMovementAction::None;
 
-	UPROPERTY(BlueprintReadOnly, Category = "ALS|State Values", ReplicatedUsing = OnRep_RotationMode)
+	UPROPERTY(BlueprintReadOnly, Category = "ALS|State Values")
 	EALSRotationMode RotationMode = EALSRotationMode::LookingDirection;
 
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|State Values")
@@ -677,9 +769,13 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ALS|State Values")
 	EALSStance Stance = EALSStance::Standing;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ALS|State Values", ReplicatedUsing = OnRep_ViewMode)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "ALS|State Values")
 	EALSViewMode ViewMode = EALSViewMode::ThirdPerson;
 
+	/* 期望状态、旋转模式、视角模式和覆盖状态打包在一起复制，保证模拟代理一次性收到完整的状态 */
+	UPROPERTY(ReplicatedUsing = OnRep_LocomotionState)
+	FALSReplicatedLocomotionState ReplicatedLocomotionState;
+
 	/** Movement System */
 
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|Movement System")
@@ -732,10 +828,64 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|Ragdoll System")
 	FVector LastRagdollVelocity = FVector::ZeroVector;
 
+	/* 骨盆线速度和角速度低于阈值持续 RagdollRestDelay 秒后，布娃娃进入静止状态 */
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System")
+	float RagdollRestLinearSpeed = 5.0f;
+
+	/* 单位：度/秒 */
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System")
+	float RagdollRestAngularSpeed = 10.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System")
+	float RagdollRestDelay = 0.5f;
+
+	/* 静止时跳过马达、重力和地面检测的更新，直到刚体被唤醒 */
+	UPROPERTY(BlueprintReadOnly, Category = "ALS|Ragdoll System")
+	bool bRagdollAtRest = false;
+
+	float RagdollRestTime = 0.0f;
+
+	/* 关节强度被量化成的等级数量 */
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System", meta = (ClampMin = "1"))
+	int32 RagdollSpringLevelCount = 8;
+
+	/* 切换等级前速度需要越过等级边界的比例，避免在边界附近来回切换 */
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System", meta = (ClampMin = "0.0", ClampMax = "0.5"))
+	float RagdollSpringHysteresis = 0.25f;
+
+	/* 当前写入约束的关节强度等级，INDEX_NONE 表示还没有写入 */
+	int32 RagdollSpringLevel = INDEX_NONE;
+
 	/* 洋娃娃运动目标位置 */
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Ragdoll System")
+	UPROPERTY(BlueprintReadOnly, Category = "ALS|Ragdoll System")
 	FVector TargetRagdollLocation = FVector::ZeroVector;
 
+	/* 每秒发送洋娃娃骨盆位置的次数 */
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System", meta = (ClampMin = "1.0"))
+	float RagdollNetSendRate = 18.0f;
+
+	/* 骨盆速度低于这个值且位置变化小于 RagdollNetRestTolerance 时视为静止，不再发送 */
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System")
+	float RagdollNetRestSpeed = 5.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System")
+	float RagdollNetRestTolerance = 1.0f;
+
+	/* 模拟代理插值时落后于最新采样的时间，通常取 1.5 个发送间隔 */
+	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = "ALS|Ragdoll System")
+	float RagdollNetInterpDelay = 0.08f;
+
+	/* 复制给模拟代理的量化骨盆位置 */
+	UPROPERTY(ReplicatedUsing = OnRep_RagdollNetLocation)
+	FVector_NetQuantize10 RagdollNetLocation = FVector::ZeroVector;
+
+	/* 最近收到的骨盆位置采样 */
+	TArray<FALSRagdollNetSample, TInlineAllocator<4>> RagdollNetBuffer;
+
+	FVector LastSentRagdollLocation = FVector::ZeroVector;
+
+	float LastRagdollSendTime = -1.0f;
+
 	// UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Ragdoll System")
 	// FRotator TargetRagdollRotation = FRotator::ZeroRotator;
 
@@ -69,6 +69,30 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ALS|Component")
 	UStaticMeshComponent* StaticMesh = nullptr;
 
+protected:
+	/*
+	 * 手上物体的组件缓存：每个模型（和动画蓝图）对应一个常驻的组件，动画实例一直保留，
+	 * 切换时只修改可见性和 Tick。SkeletalMesh / StaticMesh 指向当前使用的组件。
+	 */
+	UPROPERTY(Transient)
+	TArray<USkeletalMeshComponent*> HeldSkeletalMeshCache;
+
+	UPROPERTY(Transient)
+	TArray<UStaticMeshComponent*> HeldStaticMeshCache;
+
+	// 每种组件最多缓存的数量，超过后复用最久没有使用的组件
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|HeldObject")
+	int32 MaxHeldObjectCacheSize = 8;
+
 private:
+	USkeletalMeshComponent* FindOrAddHeldSkeletalMesh(USkeletalMesh* NewSkeletalMesh, UClass* NewAnimClass);
+
+	UStaticMeshComponent* FindOrAddHeldStaticMesh(UStaticMesh* NewStaticMesh);
+
+	static void SetHeldComponentActive(UPrimitiveComponent* Component, bool bActive);
+
 	bool bNeedsColorReset = false;
+
+	// 当前 HeldObjectRoot 附加的骨骼，相同时不再重新附加
+	FName HeldObjectAttachBone = NAME_None;
 };
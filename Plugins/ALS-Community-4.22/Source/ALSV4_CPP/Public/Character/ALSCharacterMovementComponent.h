@@ -38,11 +38,44 @@ class ALSV4_CPP_API UALSCharacterMovementComponent : public UCharacterMovementCo
 		virtual void SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel,
 		                        class FNetworkPredictionData_Client_Character& ClientData) override;
 		virtual void PrepMoveFor(class ACharacter* Character) override;
+		virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter,
+		                            float MaxDelta) const override;
 
 		// Walk Speed Update
 		// 储存运动状态是否发生变化变量
 		uint8 bSavedRequestMovementSettingsChange : 1;
 		EALSGait SavedAllowedGait = EALSGait::Walking;
+
+		// 期望状态跟随移动一起发送，服务器按移动顺序应用
+		uint8 bSavedCanInputMove : 1;
+		uint8 bSavedDesiredLaddering : 1;
+		FALSReplicatedLocomotionState SavedLocomotionState;
+	};
+
+	/*
+	 * 自定义的移动数据，在默认的移动数据后面追加运动状态和允许的步态
+	 */
+	class ALSV4_CPP_API FALSCharacterNetworkMoveData : public FCharacterNetworkMoveData
+	{
+	public:
+
+		typedef FCharacterNetworkMoveData Super;
+
+		virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove,
+		                                       ENetworkMoveType MoveType) override;
+		virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap,
+		                       ENetworkMoveType MoveType) override;
+
+		FALSReplicatedLocomotionState LocomotionState;
+		EALSGait AllowedGait = EALSGait::Walking;
+	};
+
+	class ALSV4_CPP_API FALSCharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+	{
+	public:
+		FALSCharacterNetworkMoveDataContainer();
+
+		FALSCharacterNetworkMoveData CustomDefaultMoveData[3];
 	};
 
 	/*
@@ -63,8 +96,13 @@ class ALSV4_CPP_API UALSCharacterMovementComponent : public UCharacterMovementCo
 	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
 
 	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags,
+	                            const FVector& NewAccel) override;
 	virtual void OnMovementUpdated(float DeltaTime, const FVector& OldLocation, const FVector& OldVelocity) override;
 
+	/* 重放会改写步态相关的状态，结束后恢复成重放前的真实值 */
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+
 	// Movement Settings Override
 	/*  根据运动曲线的值更新运动所需要的值 */
 	
@@ -95,6 +133,16 @@ class ALSV4_CPP_API UALSCharacterMovementComponent : public UCharacterMovementCo
 	UFUNCTION(BlueprintCallable, Category = "Movement Settings")
 	void SetAllowedGait(EALSGait NewAllowedGait);
 
-	UFUNCTION(Reliable, Server, Category = "Movement Settings")
+	/* 兼容旧的蓝图调用，允许的步态现在随保存的移动发送给服务器 */
+	UFUNCTION(BlueprintCallable, Category = "Movement Settings")
 	void Server_SetAllowedGait(EALSGait NewAllowedGait);
+
+private:
+	FALSCharacterNetworkMoveDataContainer ALSNetworkMoveDataContainer;
+
+	/* 服务器上一次收到的客户端状态，只应用有变化的部分 */
+	FALSReplicatedLocomotionState LastMoveLocomotionState;
+	uint8 bLastMoveCanInputMove : 1;
+	uint8 bLastMoveDesiredLaddering : 1;
+	uint8 bHasLastMoveState : 1;
 };
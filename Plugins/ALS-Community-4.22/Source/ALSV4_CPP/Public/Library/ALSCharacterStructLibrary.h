@@ -411,3 +411,121 @@ struct FALSHitFX : public FTableRowBase
 	UPROPERTY(EditAnywhere, Category = "Niagara")
 	FRotator NiagaraRotationOffset;
 };
+
+/*
+ * 洋娃娃骨盆位置的网络采样，模拟代理用来做插值
+ */
+USTRUCT(BlueprintType)
+struct FALSRagdollNetSample
+{
+	GENERATED_BODY()
+
+	/* 收到该采样时的本地时间 */
+	UPROPERTY(BlueprintReadOnly, Category = "Character Struct Library")
+	float Time = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Character Struct Library")
+	FVector Location = FVector::ZeroVector;
+};
+
+/*
+ * 打包复制的运动状态，自定义 NetSerialize 只写入需要的位数（共 12 位）
+ */
+USTRUCT()
+struct FALSReplicatedLocomotionState
+{
+	GENERATED_BODY()
+
+	EALSGait DesiredGait = EALSGait::Running;
+
+	EALSStance DesiredStance = EALSStance::Standing;
+
+	EALSRotationMode DesiredRotationMode = EALSRotationMode::LookingDirection;
+
+	EALSRotationMode RotationMode = EALSRotationMode::LookingDirection;
+
+	EALSViewMode ViewMode = EALSViewMode::ThirdPerson;
+
+	/* 占 4 位，新增覆盖状态时不能超过 16 个 */
+	EALSOverlayState OverlayState = EALSOverlayState::Default;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FALSReplicatedLocomotionState& Other) const
+	{
+		return DesiredGait == Other.DesiredGait && DesiredStance == Other.DesiredStance &&
+			DesiredRotationMode == Other.DesiredRotationMode && RotationMode == Other.RotationMode &&
+			ViewMode == Other.ViewMode && OverlayState == Other.OverlayState;
+	}
+
+	bool operator!=(const FALSReplicatedLocomotionState& Other) const { return !(*this == Other); }
+};
+
+template <>
+struct TStructOpsTypeTraits<FALSReplicatedLocomotionState> : public TStructOpsTypeTraitsBase2<
+		FALSReplicatedLocomotionState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+/*
+ * 量化复制的瞄准方向和加速度。Yaw、Pitch 各 12 位（约 0.09°），加速度精确到整数
+ */
+USTRUCT()
+struct FALSReplicatedAimAccel
+{
+	GENERATED_BODY()
+
+	float Yaw = 0.0f;
+
+	float Pitch = 0.0f;
+
+	FVector Acceleration = FVector::ZeroVector;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FALSReplicatedAimAccel& Other) const
+	{
+		return Yaw == Other.Yaw && Pitch == Other.Pitch && Acceleration == Other.Acceleration;
+	}
+
+	bool operator!=(const FALSReplicatedAimAccel& Other) const { return !(*this == Other); }
+};
+
+template <>
+struct TStructOpsTypeTraits<FALSReplicatedAimAccel> : public TStructOpsTypeTraitsBase2<FALSReplicatedAimAccel>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+/*
+ * 当前播放的蒙太奇，用于让后加入的客户端也能看到正在播放的蒙太奇
+ */
+USTRUCT()
+struct FALSReplicatedMontage
+{
+	GENERATED_BODY()
+
+	/* UALSMontageRegistry 中的编号，0 表示没有 */
+	UPROPERTY()
+	uint8 MontageId = 0;
+
+	UPROPERTY()
+	uint8 PackedPlayRate = 64;
+
+	/* 每播放一次加一，连续播放同一个蒙太奇时也能触发 OnRep */
+	UPROPERTY()
+	uint8 PlayCount = 0;
+
+	/* 服务器开始播放时的世界时间 */
+	UPROPERTY()
+	float StartTime = 0.0f;
+};
@@ -0,0 +1,41 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Copyright:       Copyright (C) 2021 Doğa Can Yanıkoğlu
+// License:         MIT License (http://www.opensource.org/licenses/mit-license.php)
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "ALSMontageRegistry.generated.h"
+
+class UAnimMontage;
+
+/**
+ * 需要网络同步的蒙太奇列表，网络上只传输蒙太奇在列表中的编号
+ * 编号 0 表示无效，列表中第 N 个蒙太奇的编号为 N + 1，最多 255 个
+ */
+UCLASS(BlueprintType)
+class ALSV4_CPP_API UALSMontageRegistry : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "ALS|Montage Registry")
+	uint8 FindMontageId(const UAnimMontage* Montage) const;
+
+	UFUNCTION(BlueprintCallable, Category = "ALS|Montage Registry")
+	UAnimMontage* GetMontageById(uint8 MontageId) const;
+
+	/* 播放速率量化为 8 位，范围 0 ~ 4，精度 1/64 */
+	static uint8 PackPlayRate(float PlayRate);
+
+	static float UnpackPlayRate(uint8 PackedPlayRate);
+
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Montage Registry")
+	TArray<UAnimMontage*> Montages;
+};
@@ -9,6 +9,8 @@ public class AnimationSystemTarget : TargetRules
 	{
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+		// Push model is compiled out by default in 4.27 (MARK_PROPERTY_DIRTY is a no-op without it)
+		bWithPushModel = true;
 		ExtraModuleNames.AddRange( new string[] { "AnimationSystem", "ALSV4_CPP" } );
 	}
 }
@@ -16,7 +16,8 @@ public class AnimationSystem : ModuleRules
 		{
 			"Slate",
 			"SlateCore",
-			"GameplayTags", "GameplayTasks", "GameplayAbilities"
+			"GameplayTags", "GameplayTasks", "GameplayAbilities",
+			"NetCore", "ReplicationGraph"
 		});
 
 		// Uncomment if you are using online features
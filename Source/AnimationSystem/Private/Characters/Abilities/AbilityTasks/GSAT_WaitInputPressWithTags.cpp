@@ -3,6 +3,7 @@
 
 #include "Characters/Abilities/AbilityTasks/GSAT_WaitInputPressWithTags.h"
 #include "AbilitySystemComponent.h"
+#include "Game/GSGameplayTags.h"
 
 
 UGSAT_WaitInputPressWithTags::UGSAT_WaitInputPressWithTags(const FObjectInitializer& ObjectInitializer)
@@ -66,8 +67,8 @@ void UGSAT_WaitInputPressWithTags::OnPressCallback()
 
 	//TODO extend tag query to support this and move this into it
 	// Hardcoded for GA_InteractPassive to ignore input while already interacting
-	if (AbilitySystemComponent->GetTagCount(FGameplayTag::RequestGameplayTag("State.Interacting"))
-		> AbilitySystemComponent->GetTagCount(FGameplayTag::RequestGameplayTag("State.InteractingRemoval")))
+	if (AbilitySystemComponent->GetTagCount(FGSGameplayTags::Get().State_Interacting)
+		> AbilitySystemComponent->GetTagCount(FGSGameplayTags::Get().State_InteractingRemoval))
 	{
 		Reset();
 		return;
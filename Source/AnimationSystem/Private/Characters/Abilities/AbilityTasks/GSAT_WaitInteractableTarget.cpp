@@ -7,13 +7,13 @@
 #include "DrawDebugHelpers.h"
 #include "TimerManager.h"
 #include "Game/AnimationSystem.h"
+#include "Game/GSInteractableSubsystem.h"
 
 const FName NAME_FP_Camera(TEXT("FP_Camera"));
 
 UGSAT_WaitInteractableTarget::UGSAT_WaitInteractableTarget(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-	bTraceAffectsAimPitch = true;
 }
 
 UGSAT_WaitInteractableTarget* UGSAT_WaitInteractableTarget::WaitForInteractableTarget(
@@ -41,10 +41,30 @@ UGSAT_WaitInteractableTarget* UGSAT_WaitInteractableTarget::WaitForInteractableT
 void UGSAT_WaitInteractableTarget::Activate()
 {
 	UWorld* World = GetWorld();
+	AActor* SourceActor = Ability->GetCurrentActorInfo()->AvatarActor.Get();
+
+	CurrentTargetHit = FHitResult();
+	OcclusionQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(GSAT_WaitInteractableTarget), false, SourceActor);
+
+	// 附近没有可交互物体时不检测，由交互索引通知什么时候开始
+	UGSInteractableSubsystem* InteractableSubsystem = World->GetSubsystem<UGSInteractableSubsystem>();
+	if (InteractableSubsystem)
+	{
+		ProximityWatcherId = InteractableSubsystem->AddProximityWatcher(
+			SourceActor, MaxRange,
+			FGSInteractableProximityDelegate::CreateUObject(this, &UGSAT_WaitInteractableTarget::OnProximityChanged),
+			bHasNearbyInteractable);
+	}
+
+	if (ProximityWatcherId == INDEX_NONE)
+	{
+		bHasNearbyInteractable = true;
+	}
 
-	// 激活之后进行射线检测
-	World->GetTimerManager().SetTimer(TraceTimerHandle, this, &UGSAT_WaitInteractableTarget::PerformTrace, TimerPeriod,
-	                                  true);
+	if (bHasNearbyInteractable)
+	{
+		ScheduleNextTrace(TimerPeriod);
+	}
 }
 
 void UGSAT_WaitInteractableTarget::OnDestroy(bool AbilityEnded)
@@ -52,121 +72,107 @@ void UGSAT_WaitInteractableTarget::OnDestroy(bool AbilityEnded)
 	UWorld* World = GetWorld();
 	World->GetTimerManager().ClearTimer(TraceTimerHandle);
 
+	if (UGSInteractableSubsystem* InteractableSubsystem = World->GetSubsystem<UGSInteractableSubsystem>())
+	{
+		InteractableSubsystem->RemoveProximityWatcher(ProximityWatcherId);
+	}
+	ProximityWatcherId = INDEX_NONE;
+
 	Super::OnDestroy(AbilityEnded);
 }
 
-void UGSAT_WaitInteractableTarget::LineTrace(FHitResult& OutHitResult, const UWorld* World, const FVector& Start,
-                                             const FVector& End, FName ProfileName, const FCollisionQueryParams Params,
-                                             bool bLookForInteractableActor) const
+void UGSAT_WaitInteractableTarget::ScheduleNextTrace(float Delay)
 {
-	check(World);
-
-	// 多射线检测
-	TArray<FHitResult> HitResults;
-	World->LineTraceMultiByProfile(HitResults, Start, End, ProfileName, Params);
+	GetWorld()->GetTimerManager().SetTimer(TraceTimerHandle, this, &UGSAT_WaitInteractableTarget::PerformTrace,
+	                                       FMath::Max(Delay, KINDA_SMALL_NUMBER), false);
+}
 
-	OutHitResult.TraceStart = Start;
-	OutHitResult.TraceEnd = End;
+void UGSAT_WaitInteractableTarget::OnProximityChanged(bool bHasNearby)
+{
+	bHasNearbyInteractable = bHasNearby;
 
-	// 对射线结果进行遍历
-	for (int32 HitIdx = 0; HitIdx < HitResults.Num(); ++HitIdx)
+	if (bHasNearby)
 	{
-		const FHitResult& Hit = HitResults[HitIdx];
-
-		if (!Hit.Actor.IsValid() || Hit.Actor != Ability->GetCurrentActorInfo()->AvatarActor.Get())
+		if (!GetWorld()->GetTimerManager().IsTimerActive(TraceTimerHandle))
 		{
-			// If bLookForInteractableActor is false, we're looking for an endpoint to trace to
-			// 如果bLookForInteractableActor 是 false，那么就是正在寻找要跟踪的端点。
-			if (bLookForInteractableActor && Hit.Actor.IsValid())
-			{
-				// 当bLookForInteractableActor为true时，命中组件必须重叠COLLISION_INTERACTABLE跟踪通道
-				// 这样，一个很大的Actor就可以有一个小的交互按钮。
-				if (Hit.Component.IsValid() && Hit.Component.Get()->GetCollisionResponseToChannel(
-						COLLISION_INTERACTABLE)
-					== ECollisionResponse::ECR_Overlap)
-				{
-					// Component/Actor must be available to interact
-					bool bIsInteractable = Hit.Actor.Get()->Implements<UGSInteractable>();
-
-					if (bIsInteractable && IGSInteractable::Execute_IsAvailableForInteraction(
-						Hit.Actor.Get(), Hit.Component.Get()))
-					{
-						OutHitResult = Hit;
-						OutHitResult.bBlockingHit = true; // treat it as a blocking hit
-						return;
-					}
-				}
-
-				OutHitResult.TraceEnd = Hit.Location;
-				OutHitResult.bBlockingHit = false; // False means it isn't valid to interact with
-				return;
-			}
-
-			// This is for the first line trace to get an end point to trace to
-			// !Hit.Actor.IsValid() implies we didn't hit anything so return the endpoint as a blocking hit
-			// Or if we hit something else
-			OutHitResult = Hit;
-			OutHitResult.bBlockingHit = true; // treat it as a blocking hit
-			return;
+			ScheduleNextTrace(TimerPeriod);
 		}
 	}
-}
-
-void UGSAT_WaitInteractableTarget::AimWithPlayerController(const AActor* InSourceActor, FCollisionQueryParams Params,
-                                                           const FVector& TraceStart, FVector& OutTraceEnd,
-                                                           bool bIgnorePitch) const
-{
-	if (!Ability) // Server and launching client only
+	else
 	{
-		return;
+		// 最后检测一次，让之前的目标收到 Lost，之后不再安排检测
+		GetWorld()->GetTimerManager().ClearTimer(TraceTimerHandle);
+		PerformTrace();
 	}
+}
 
-	APlayerController* PC = Ability->GetCurrentActorInfo()->PlayerController.Get();
+void UGSAT_WaitInteractableTarget::GetAimRay(const FVector& TraceStart, FVector& OutViewStart, FVector& OutViewDir,
+                                            FVector& OutTraceEnd) const
+{
+	APlayerController* PC = Ability ? Ability->GetCurrentActorInfo()->PlayerController.Get() : nullptr;
 
 	// Default to TraceStart if no PlayerController
-	FVector ViewStart = TraceStart;
+	OutViewStart = TraceStart;
 	FRotator ViewRot(0.0f);
 	if (PC)
 	{
-		PC->GetPlayerViewPoint(ViewStart, ViewRot);
+		PC->GetPlayerViewPoint(OutViewStart, ViewRot);
 	}
 
-	const FVector ViewDir = ViewRot.Vector();
-	FVector ViewEnd = ViewStart + (ViewDir * MaxRange);
-
-	ClipCameraRayToAbilityRange(ViewStart, ViewDir, TraceStart, MaxRange, ViewEnd);
+	OutViewDir = ViewRot.Vector();
+	FVector ViewEnd = OutViewStart + (OutViewDir * MaxRange);
 
-	FHitResult HitResult;
-	LineTrace(HitResult, InSourceActor->GetWorld(), ViewStart, ViewEnd, TraceProfile.Name, Params, false);
+	ClipCameraRayToAbilityRange(OutViewStart, OutViewDir, TraceStart, MaxRange, ViewEnd);
 
-	const bool bUseTraceResult = HitResult.bBlockingHit && (FVector::DistSquared(TraceStart, HitResult.Location) <= (
-		MaxRange * MaxRange));
+	FVector AimDir = (ViewEnd - TraceStart).GetSafeNormal();
+	if (AimDir.IsZero())
+	{
+		AimDir = OutViewDir;
+	}
 
-	const FVector AdjustedEnd = (bUseTraceResult) ? HitResult.Location : ViewEnd;
+	OutTraceEnd = TraceStart + (AimDir * MaxRange);
+}
 
-	FVector AdjustedAimDir = (AdjustedEnd - TraceStart).GetSafeNormal();
-	if (AdjustedAimDir.IsZero())
+bool UGSAT_WaitInteractableTarget::FindInteractableTarget(const AActor* SourceActor, const FVector& TraceStart,
+                                                          const FVector& ViewStart, const FVector& ViewDir,
+                                                          FHitResult& OutHitResult) const
+{
+	UWorld* World = GetWorld();
+	const UGSInteractableSubsystem* InteractableSubsystem = World->GetSubsystem<UGSInteractableSubsystem>();
+	if (!InteractableSubsystem)
 	{
-		AdjustedAimDir = ViewDir;
+		return false;
 	}
 
-	if (!bTraceAffectsAimPitch && bUseTraceResult)
-	{
-		FVector OriginalAimDir = (ViewEnd - TraceStart).GetSafeNormal();
+	FGSInteractableQuery Query;
+	Query.ViewStart = ViewStart;
+	Query.ViewDir = ViewDir;
+	Query.RangeCenter = TraceStart;
+	Query.MaxRange = MaxRange;
+	Query.ConeHalfAngle = AimConeHalfAngle;
+	Query.IgnoreActor = SourceActor;
 
-		if (!OriginalAimDir.IsZero())
-		{
-			// Convert to angles and use original pitch
-			const FRotator OriginalAimRot = OriginalAimDir.Rotation();
+	FGSInteractableCandidate Candidate;
+	if (!InteractableSubsystem->FindBestInteractable(Query, Candidate))
+	{
+		return false;
+	}
 
-			FRotator AdjustedAimRot = AdjustedAimDir.Rotation();
-			AdjustedAimRot.Pitch = OriginalAimRot.Pitch;
+	AActor* TargetActor = Candidate.Component->GetOwner();
 
-			AdjustedAimDir = AdjustedAimRot.Vector();
-		}
+	// 只对最佳候选做一次遮挡确认，先命中的不是目标就说明被挡住了
+	FHitResult OcclusionHit;
+	if (World->LineTraceSingleByProfile(OcclusionHit, TraceStart, Candidate.Location, TraceProfile.Name,
+	                                    OcclusionQueryParams)
+		&& OcclusionHit.Actor.Get() != TargetActor)
+	{
+		return false;
 	}
 
-	OutTraceEnd = TraceStart + (AdjustedAimDir * MaxRange);
+	OutHitResult = FHitResult(TargetActor, Candidate.Component, Candidate.Location, -ViewDir);
+	OutHitResult.TraceStart = TraceStart;
+	OutHitResult.bBlockingHit = true; // treat it as a blocking hit
+	return true;
 }
 
 bool UGSAT_WaitInteractableTarget::ClipCameraRayToAbilityRange(FVector CameraLocation, FVector CameraDirection,
@@ -195,9 +201,6 @@ bool UGSAT_WaitInteractableTarget::ClipCameraRayToAbilityRange(FVector CameraLoc
 
 void UGSAT_WaitInteractableTarget::PerformTrace()
 {
-	bool bTraceComplex = false;
-	TArray<AActor*> ActorsToIgnore;
-
 	AActor* SourceActor = Ability->GetCurrentActorInfo()->AvatarActor.Get();
 	if (!SourceActor)
 	{
@@ -206,26 +209,26 @@ void UGSAT_WaitInteractableTarget::PerformTrace()
 		return;
 	}
 
-	ActorsToIgnore.Add(SourceActor);
-
 	// Check player's perspective, could be 1P or 3P
 	AGSHeroCharacter* Hero = Cast<AGSHeroCharacter>(SourceActor);
 
-	FCollisionQueryParams Params(SCENE_QUERY_STAT(AGameplayAbilityTargetActor_SingleLineTrace), bTraceComplex);
-	Params.bReturnPhysicalMaterial = true;
-	Params.AddIgnoredActors(ActorsToIgnore);
-
 	// Calculate TraceEnd
 	FVector TraceStart = StartLocation.GetTargetingTransform().GetLocation();
+	FVector ViewStart;
+	FVector ViewDir;
 	FVector TraceEnd;
-	// 仅对服务器和启动客户端有效
-	AimWithPlayerController(SourceActor, Params, TraceStart, TraceEnd);
+	GetAimRay(TraceStart, ViewStart, ViewDir, TraceEnd);
 
 	// ------------------------------------------------------
 
 	FHitResult ReturnHitResult;
-	LineTrace(ReturnHitResult, GetWorld(), TraceStart, TraceEnd, TraceProfile.Name, Params, true);
+	ReturnHitResult.TraceStart = TraceStart;
+	ReturnHitResult.TraceEnd = TraceEnd;
+	FindInteractableTarget(SourceActor, TraceStart, ViewStart, ViewDir, ReturnHitResult);
+	ReturnHitResult.TraceEnd = TraceEnd;
+
 
+	AActor* OldTarget = CurrentTargetHit.Actor.Get();
 
 	// bBlockingHit = valid, available Interactable Actor
 	if (!ReturnHitResult.bBlockingHit) // 没有找到物体
@@ -235,44 +238,32 @@ void UGSAT_WaitInteractableTarget::PerformTrace()
 		// 如果没有找到有效的、可用的交互式Actor，则默认为跟踪行的终点
 		ReturnHitResult.Location = TraceEnd;
 
-		if (TargetData.Num() > 0) // 但是保存了之前的数据
+		if (OldTarget) // 但是保存了之前的数据
 		{
-			AActor* Item = TargetData.Get(0)->GetHitResult()->Actor.Get();
-			if (Item)
+			// Previous trace had a valid Interactable Actor, now we don't have one
+			// Broadcast last valid target
+			LostInteractableTarget.Broadcast(MakeTargetData(CurrentTargetHit));
+			AGSASCActorBase* InteractActor = Cast<AGSASCActorBase>(OldTarget);
+			if (InteractActor)
 			{
-				// Previous trace had a valid Interactable Actor, now we don't have one
-				// Broadcast last valid target
-				LostInteractableTarget.Broadcast(TargetData);
-				AGSASCActorBase* InteractActor = Cast<AGSASCActorBase>(Item);
-				if (InteractActor)
-				{
-					InteractActor->TouchEnd(Hero);
-				}
+				InteractActor->TouchEnd(Hero);
 			}
 		}
 
-		TargetData = MakeTargetData(ReturnHitResult);
+		CurrentTargetHit = ReturnHitResult;
 	}
 	else // 找到了物体
 	{
 		// Valid, available Interactable Actor
 
-		bool bBroadcastNewTarget = true;
-
-		if (TargetData.Num() > 0) // 数据种还保存着之前的数据
+		// 如果和之前的物体一样，就不用进行广播了。
+		if (OldTarget != ReturnHitResult.Actor.Get())
 		{
-			AActor* OldTarget = TargetData.Get(0)->GetHitResult()->Actor.Get();
-
-			if (OldTarget == ReturnHitResult.Actor.Get())
-			{
-				// 如果和之前的物体一样，就不用进行广播了。
-				bBroadcastNewTarget = false;
-			}
-			else if (OldTarget) // 找到了新物体
+			if (OldTarget) // 找到了新物体
 			{
 				// 找到了物体，并且这个新物体和之前的不一样。
 				// 将之前的物体传递给 Lost 
-				LostInteractableTarget.Broadcast(TargetData);
+				LostInteractableTarget.Broadcast(MakeTargetData(CurrentTargetHit));
 
 				AGSASCActorBase* InteractActor = Cast<AGSASCActorBase>(OldTarget);
 				if (InteractActor)
@@ -280,14 +271,11 @@ void UGSAT_WaitInteractableTarget::PerformTrace()
 					InteractActor->TouchEnd(Hero);
 				}
 			}
-		}
 
-		if (bBroadcastNewTarget)
-		{
 			// 到这里就说明新的物体有效
-			// 将新的物体广播给 Found
-			TargetData = MakeTargetData(ReturnHitResult);
-			FoundNewInteractableTarget.Broadcast(TargetData);
+			// 记录新的物体并广播给 Found
+			CurrentTargetHit = ReturnHitResult;
+			FoundNewInteractableTarget.Broadcast(MakeTargetData(CurrentTargetHit));
 
 			AGSASCActorBase* NowInteractActor = Cast<AGSASCActorBase>(ReturnHitResult.Actor.Get());
 			if (NowInteractActor)
@@ -297,6 +285,26 @@ void UGSAT_WaitInteractableTarget::PerformTrace()
 		}
 	}
 
+	// 根据视角角速度和移动速度调整下一次检测的间隔
+	if (bHasNearbyInteractable)
+	{
+		const float Now = GetWorld()->GetTimeSeconds();
+		const float DeltaTime = Now - LastTraceTime;
+		float Activity = 1.f;
+		if (LastTraceTime >= 0.f && DeltaTime > KINDA_SMALL_NUMBER && !LastViewDir.IsZero())
+		{
+			const float TurnAngle = FMath::RadiansToDegrees(
+				FMath::Acos(FMath::Clamp(FVector::DotProduct(LastViewDir, ViewDir), -1.f, 1.f)));
+			const float MoveSpeed = SourceActor->GetVelocity().Size();
+			Activity = FMath::Clamp(FMath::Max(TurnAngle / DeltaTime / FastTurnRate, MoveSpeed / FastMoveSpeed), 0.f,
+			                        1.f);
+		}
+
+		LastViewDir = ViewDir;
+		LastTraceTime = Now;
+		ScheduleNextTrace(FMath::Lerp(TimerPeriod * IdlePeriodScale, TimerPeriod, Activity));
+	}
+
 #if ENABLE_DRAW_DEBUG
 
 	if (Hero->GetShowTraces())
@@ -318,5 +326,5 @@ void UGSAT_WaitInteractableTarget::PerformTrace()
 FGameplayAbilityTargetDataHandle UGSAT_WaitInteractableTarget::MakeTargetData(const FHitResult& HitResult) const
 {
 	/** Note: This will be cleaned up by the FGameplayAbilityTargetDataHandle (via an internal TSharedPtr) */
-	return StartLocation.MakeTargetDataHandleFromHitResult(Ability, HitResult);
+	return FGameplayAbilityTargetDataHandle(new FGameplayAbilityTargetData_SingleTargetHit(HitResult));
 }
@@ -2,14 +2,64 @@
 
 
 #include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
+#include "Game/GSGameplayTags.h"
 #include "GameplayEffectExtension.h"
 #include "Net/UnrealNetwork.h"
 
+namespace
+{
+	// 一种弹药对应的 (备弹, 最大备弹) 属性
+	struct FGSAmmoAttributeRow
+	{
+		FGameplayTag AmmoTag;
+		FGameplayAttribute ReserveAttribute;
+		FGameplayAttribute MaxReserveAttribute;
+	};
+
+	struct FGSAmmoAttributeTable
+	{
+		TArray<FGSAmmoAttributeRow> Rows;
+		TMap<FGameplayTag, int32> RowByTag;
+		TMap<FGameplayAttribute, int32> RowByReserveAttribute;
+
+		FGSAmmoAttributeTable()
+		{
+			const FGSGameplayTags& Tags = FGSGameplayTags::Get();
+			AddRow(Tags.Weapon_Ammo_Rifle, UGSAmmoAttributeSet::GetRifleReserveAmmoAttribute(), UGSAmmoAttributeSet::GetMaxRifleReserveAmmoAttribute());
+			AddRow(Tags.Weapon_Ammo_Rocket, UGSAmmoAttributeSet::GetRocketReserveAmmoAttribute(), UGSAmmoAttributeSet::GetMaxRocketReserveAmmoAttribute());
+			AddRow(Tags.Weapon_Ammo_Shotgun, UGSAmmoAttributeSet::GetShotgunReserveAmmoAttribute(), UGSAmmoAttributeSet::GetMaxShotgunReserveAmmoAttribute());
+		}
+
+		void AddRow(const FGameplayTag& AmmoTag, const FGameplayAttribute& Reserve, const FGameplayAttribute& MaxReserve)
+		{
+			const int32 Index = Rows.Add({AmmoTag, Reserve, MaxReserve});
+			RowByTag.Add(AmmoTag, Index);
+			RowByReserveAttribute.Add(Reserve, Index);
+		}
+
+		const FGSAmmoAttributeRow* FindByTag(const FGameplayTag& AmmoTag) const
+		{
+			const int32* Index = RowByTag.Find(AmmoTag);
+			return Index ? &Rows[*Index] : nullptr;
+		}
+
+		const FGSAmmoAttributeRow* FindByReserveAttribute(const FGameplayAttribute& Attribute) const
+		{
+			const int32* Index = RowByReserveAttribute.Find(Attribute);
+			return Index ? &Rows[*Index] : nullptr;
+		}
+	};
+
+	// 第一次使用时构建，之后只读
+	const FGSAmmoAttributeTable& GetAmmoAttributeTable()
+	{
+		static const FGSAmmoAttributeTable Table;
+		return Table;
+	}
+}
+
 UGSAmmoAttributeSet::UGSAmmoAttributeSet()
 {
-	RifleAmmoTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rifle"));
-	RocketAmmoTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rocket"));
-	ShotgunAmmoTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Shotgun"));
 }
 
 void UGSAmmoAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue)
@@ -21,20 +71,17 @@ void UGSAmmoAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 {
 	Super::PostGameplayEffectExecute(Data);
 
-	if (Data.EvaluatedData.Attribute == GetRifleReserveAmmoAttribute())
-	{
-		const float Ammo = GetRifleReserveAmmo();
-		SetRifleReserveAmmo(FMath::Clamp<float>(Ammo, 0, GetMaxRifleReserveAmmo()));
-	}
-	else if (Data.EvaluatedData.Attribute == GetRocketReserveAmmoAttribute())
+	// 备弹不能超过对应的最大备弹
+	if (const FGSAmmoAttributeRow* Row = GetAmmoAttributeTable().FindByReserveAttribute(Data.EvaluatedData.Attribute))
 	{
-		const float Ammo = GetRocketReserveAmmo();
-		SetRocketReserveAmmo(FMath::Clamp<float>(Ammo, 0, GetMaxRocketReserveAmmo()));
-	}
-	else if (Data.EvaluatedData.Attribute == GetShotgunReserveAmmoAttribute())
-	{
-		const float Ammo = GetShotgunReserveAmmo();
-		SetShotgunReserveAmmo(FMath::Clamp<float>(Ammo, 0, GetMaxShotgunReserveAmmo()));
+		const float Ammo = Row->ReserveAttribute.GetNumericValue(this);
+		const float MaxAmmo = Row->MaxReserveAttribute.GetNumericValue(this);
+
+		UAbilitySystemComponent* AbilityComp = GetOwningAbilitySystemComponent();
+		if (ensure(AbilityComp))
+		{
+			AbilityComp->SetNumericAttributeBase(Row->ReserveAttribute, FMath::Clamp<float>(Ammo, 0, MaxAmmo));
+		}
 	}
 }
 
@@ -50,40 +97,16 @@ void UGSAmmoAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME_CONDITION_NOTIFY(UGSAmmoAttributeSet, MaxShotgunReserveAmmo, COND_None, REPNOTIFY_Always);
 }
 
-FGameplayAttribute UGSAmmoAttributeSet::GetReserveAmmoAttributeFromTag(FGameplayTag& PrimaryAmmoTag)
+FGameplayAttribute UGSAmmoAttributeSet::GetReserveAmmoAttributeFromTag(const FGameplayTag& PrimaryAmmoTag)
 {
-	if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rifle")))
-	{
-		return GetRifleReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rocket")))
-	{
-		return GetRocketReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Shotgun")))
-	{
-		return GetShotgunReserveAmmoAttribute();
-	}
-
-	return FGameplayAttribute();
+	const FGSAmmoAttributeRow* Row = GetAmmoAttributeTable().FindByTag(PrimaryAmmoTag);
+	return Row ? Row->ReserveAttribute : FGameplayAttribute();
 }
 
-FGameplayAttribute UGSAmmoAttributeSet::GetMaxReserveAmmoAttributeFromTag(FGameplayTag& PrimaryAmmoTag)
+FGameplayAttribute UGSAmmoAttributeSet::GetMaxReserveAmmoAttributeFromTag(const FGameplayTag& PrimaryAmmoTag)
 {
-	if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rifle")))
-	{
-		return GetMaxRifleReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rocket")))
-	{
-		return GetMaxRocketReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Shotgun")))
-	{
-		return GetMaxShotgunReserveAmmoAttribute();
-	}
-
-	return FGameplayAttribute();
+	const FGSAmmoAttributeRow* Row = GetAmmoAttributeTable().FindByTag(PrimaryAmmoTag);
+	return Row ? Row->MaxReserveAttribute : FGameplayAttribute();
 }
 
 void UGSAmmoAttributeSet::AdjustAttributeForMaxChange(const FGameplayAttributeData& AffectedAttribute, const FGameplayAttributeData& MaxAttribute, float NewMaxValue, const FGameplayAttribute& AffectedAttributeProperty) const
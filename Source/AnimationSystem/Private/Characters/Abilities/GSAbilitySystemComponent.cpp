@@ -27,35 +27,78 @@ void UGSAbilitySystemComponent::AbilityLocalInputPressed(int32 InputID)
 	// ---------------------------------------------------------
 
 	ABILITYLIST_SCOPE_LOCK();
-	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	for (TMultiMap<int32, FGSInputBinding>::TKeyIterator It = InputBindings.CreateKeyIterator(InputID); It; ++It)
 	{
-		if (Spec.InputID == InputID)
+		FGSInputBinding& Binding = It.Value();
+		FGameplayAbilitySpec* Spec = FindSpecForBinding(Binding);
+		if (!Spec || !Spec->Ability)
 		{
-			if (Spec.Ability)
+			continue;
+		}
+
+		Spec->InputPressed = true;
+		if (Spec->IsActive())
+		{
+			if (Spec->Ability->bReplicateInputDirectly && IsOwnerActorAuthoritative() == false)
 			{
-				Spec.InputPressed = true;
-				if (Spec.IsActive())
-				{
-					if (Spec.Ability->bReplicateInputDirectly && IsOwnerActorAuthoritative() == false)
-					{
-						ServerSetInputPressed(Spec.Handle);
-					}
-
-					AbilitySpecInputPressed(Spec);
-
-					// Invoke the InputPressed event. This is not replicated here. If someone is listening, they may replicate the InputPressed event to the server.
-					InvokeReplicatedEvent(EAbilityGenericReplicatedEvent::InputPressed, Spec.Handle, Spec.ActivationInfo.GetActivationPredictionKey());
-				}
-				else
-				{
-					UGSGameplayAbility* GA = Cast<UGSGameplayAbility>(Spec.Ability);
-					if (GA && GA->bActivateOnInput)
-					{
-						// Ability is not active, so try to activate it
-						TryActivateAbility(Spec.Handle);
-					}
-				}
+				ServerSetInputPressed(Spec->Handle);
 			}
+
+			AbilitySpecInputPressed(*Spec);
+
+			// Invoke the InputPressed event. This is not replicated here. If someone is listening, they may replicate the InputPressed event to the server.
+			InvokeReplicatedEvent(EAbilityGenericReplicatedEvent::InputPressed, Spec->Handle, Spec->ActivationInfo.GetActivationPredictionKey());
+		}
+		else if (Binding.bActivateOnInput)
+		{
+			// Ability is not active, so try to activate it
+			TryActivateAbility(Spec->Handle);
 		}
 	}
-}
\ No newline at end of file
+}
+
+void UGSAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+
+	if (AbilitySpec.InputID == INDEX_NONE)
+	{
+		return;
+	}
+
+	FGSInputBinding Binding;
+	Binding.Handle = AbilitySpec.Handle;
+	const UGSGameplayAbility* GA = Cast<UGSGameplayAbility>(AbilitySpec.Ability);
+	Binding.bActivateOnInput = GA && GA->bActivateOnInput;
+	InputBindings.Add(AbilitySpec.InputID, Binding);
+}
+
+void UGSAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	for (TMultiMap<int32, FGSInputBinding>::TKeyIterator It = InputBindings.CreateKeyIterator(AbilitySpec.InputID); It; ++It)
+	{
+		if (It.Value().Handle == AbilitySpec.Handle)
+		{
+			It.RemoveCurrent();
+			break;
+		}
+	}
+
+	Super::OnRemoveAbility(AbilitySpec);
+}
+
+FGameplayAbilitySpec* UGSAbilitySystemComponent::FindSpecForBinding(FGSInputBinding& Binding)
+{
+	TArray<FGameplayAbilitySpec>& Items = ActivatableAbilities.Items;
+	if (Items.IsValidIndex(Binding.SpecIndex) && Items[Binding.SpecIndex].Handle == Binding.Handle)
+	{
+		return &Items[Binding.SpecIndex];
+	}
+
+	// 只有在其他能力被移除、数组移动之后才需要重新查找
+	Binding.SpecIndex = Items.IndexOfByPredicate([&Binding](const FGameplayAbilitySpec& Spec)
+	{
+		return Spec.Handle == Binding.Handle;
+	});
+	return Binding.SpecIndex != INDEX_NONE ? &Items[Binding.SpecIndex] : nullptr;
+}
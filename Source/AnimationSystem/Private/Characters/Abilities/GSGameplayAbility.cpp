@@ -4,6 +4,7 @@
 #include "Characters/Abilities/GSGameplayAbility.h"
 
 #include "AbilitySystemComponent.h"
+#include "Game/GSGameplayTags.h"
 
 UGSGameplayAbility::UGSGameplayAbility()
 {
@@ -14,9 +15,9 @@ UGSGameplayAbility::UGSGameplayAbility()
 	// bCannotActivateWhileInteracting = true;
 
 	// UGSAbilitySystemGlobals hasn't initialized tags yet to set ActivationBlockedTags
-	ActivationBlockedTags.AddTag(FGameplayTag::RequestGameplayTag("State.Dead"));
-	ActivationBlockedTags.AddTag(FGameplayTag::RequestGameplayTag("State.KnockedDown"));
-	ActivationOwnedTags.AddTag(FGameplayTag::RequestGameplayTag("Ability.BlocksInteraction"));
+	ActivationBlockedTags.AddTag(FGSGameplayTags::Get().State_Dead);
+	ActivationBlockedTags.AddTag(FGSGameplayTags::Get().State_KnockedDown);
+	ActivationOwnedTags.AddTag(FGSGameplayTags::Get().Ability_BlocksInteraction);
 
 	// InteractingTag = FGameplayTag::RequestGameplayTag("State.Interacting");
 	// InteractingRemovalTag = FGameplayTag::RequestGameplayTag("State.InteractingRemoval");
@@ -4,6 +4,7 @@
 #include "Characters/Abilities/GSInteractable.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
+#include "Game/GSGameplayTags.h"
 
 // Add default functionality here for any IGSInteractable functions that are not pure virtual.
 bool IGSInteractable::IsAvailableForInteraction_Implementation(UPrimitiveComponent* InteractionComponent) const
@@ -65,7 +66,7 @@ void IGSInteractable::InteractableCancelInteraction_Implementation(UPrimitiveCom
 	if (Interacters.Contains(InteractionComponent))
 	{
 		FGameplayTagContainer InteractAbilityTagContainer;
-		InteractAbilityTagContainer.AddTag(FGameplayTag::RequestGameplayTag("Ability.Interaction"));
+		InteractAbilityTagContainer.AddTag(FGSGameplayTags::Get().Ability_Interaction);
 
 		TArray<AActor*>& InteractingActors = Interacters[InteractionComponent];
 		for (AActor* InteractingActor : InteractingActors)
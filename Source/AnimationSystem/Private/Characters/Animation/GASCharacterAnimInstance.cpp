@@ -4,6 +4,7 @@
 #include "Characters/Animation/GASCharacterAnimInstance.h"
 
 #include "Characters/Heroes/GSHeroCharacter.h"
+#include "Game/GSGameplayTags.h"
 #include "Items/Weapons/GSWeapon.h"
 
 void UGASCharacterAnimInstance::NativeInitializeAnimation()
@@ -37,15 +38,15 @@ void UGASCharacterAnimInstance::PickUpEnd()
 	const AGSWeapon* PickUpWeapon = Cast<AGSWeapon>(Item);
 	if (PickUpWeapon)
 	{
-		if (PickUpWeapon->WeaponTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Equipped.Pistol")))
+		if (PickUpWeapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Pistol)
 		{
 			GASCharacter->ShowPistolMesh(true);
 		}
-		else if (PickUpWeapon->WeaponTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Equipped.Rifle")))
+		else if (PickUpWeapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Rifle)
 		{
 			GASCharacter->ShowRifleMesh(true);
 		}
-		else if (PickUpWeapon->WeaponTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Equipped.Bow")))
+		else if (PickUpWeapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Bow)
 		{
 			GASCharacter->ShowBowMesh(true);
 		}
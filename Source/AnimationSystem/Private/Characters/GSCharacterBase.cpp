@@ -5,6 +5,7 @@
 
 #include "Characters/Abilities/GSAbilitySystemComponent.h"
 #include "Characters/Abilities/GSGameplayAbility.h"
+#include "Game/GSLagCompensationSubsystem.h"
 
 
 AGSCharacterBase::AGSCharacterBase(const FObjectInitializer& ObjectInitializer)
@@ -43,6 +44,25 @@ float AGSCharacterBase::GetHealth() const
 void AGSCharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// 服务器记录命中盒历史，用于验证客户端的射击
+	if (HasAuthority())
+	{
+		if (UGSLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UGSLagCompensationSubsystem>())
+		{
+			LagCompensation->RegisterCharacter(this);
+		}
+	}
+}
+
+void AGSCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGSLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UGSLagCompensationSubsystem>())
+	{
+		LagCompensation->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AGSCharacterBase::AddCharacterAbilities()
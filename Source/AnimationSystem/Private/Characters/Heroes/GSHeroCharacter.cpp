@@ -6,11 +6,14 @@
 #include "MotionWarpingComponent.h"
 #include "Characters/Abilities/GSAbilitySystemComponent.h"
 #include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
+#include "Game/GSGameplayTags.h"
+#include "Game/GSInteractableSubsystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Items/Weapons/GSWeapon.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Player/GASPlayerController.h"
 #include "Player/GSPlayerState.h"
 #include "Sound/SoundCue.h"
@@ -47,23 +50,24 @@ AGSHeroCharacter::AGSHeroCharacter(const FObjectInitializer& ObjectInitializer)
 
 	MotionWarpingComponent = CreateDefaultSubobject<UMotionWarpingComponent>(FName("MotionWarping"));
 
-	NoWeaponTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Equipped.None"));
-	WeaponChangingDelayReplicationTag = FGameplayTag::RequestGameplayTag(
-		FName("Ability.Weapon.IsChangingDelayReplication"));
-	WeaponAmmoTypeNoneTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.None"));
-	WeaponAbilityTag = FGameplayTag::RequestGameplayTag(FName("Ability.Weapon"));
+	NoWeaponTag = FGSGameplayTags::Get().Weapon_Equipped_None;
+	WeaponChangingDelayReplicationTag = FGSGameplayTags::Get().Ability_Weapon_IsChangingDelayReplication;
+	WeaponAmmoTypeNoneTag = FGSGameplayTags::Get().Weapon_Ammo_None;
+	WeaponAbilityTag = FGSGameplayTags::Get().Ability_Weapon;
 	CurrentWeaponTag = NoWeaponTag;
-	Inventory = FGSHeroInventory();
+	Inventory.Owner = this;
 
-	KnockedDownTag = FGameplayTag::RequestGameplayTag("State.KnockedDown");
-	InteractingTag = FGameplayTag::RequestGameplayTag("State.Interacting");
+	KnockedDownTag = FGSGameplayTags::Get().State_KnockedDown;
+	InteractingTag = FGSGameplayTags::Get().State_Interacting;
 }
 
 void AGSHeroCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AGSHeroCharacter, Inventory);
+	FDoRepLifetimeParams InventoryParams;
+	InventoryParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AGSHeroCharacter, Inventory, InventoryParams);
 	// Only replicate CurrentWeapon to simulated clients and manually sync CurrentWeeapon with Owner when we're ready.
 	// This allows us to predict weapon changing.
 	DOREPLIFETIME_CONDITION(AGSHeroCharacter, CurrentWeapon, COND_SimulatedOnly);
@@ -107,14 +111,8 @@ bool AGSHeroCharacter::AddWeaponToInventory(AGSPickup* NewItem)
 	SetOverlayState(EALSOverlayState::Default);
 
 	// 没有这个武器，将武器添加到背包中
-	if (NewWeapon)
-	{
-		Inventory.Weapons.Add(NewWeapon);
-	}
-	else
-	{
-		Inventory.PickUpItems.Add(NewItem);
-	}
+	Inventory.AddItem(NewItem);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AGSHeroCharacter, Inventory, this);
 
 	UAnimMontage* PickUpAnimMontage = NewItem->GetPickUpMontage(GetStance());
 
@@ -181,33 +179,72 @@ bool AGSHeroCharacter::AddWeaponToInventory(AGSPickup* NewItem)
 	return true;
 }
 
+void AGSHeroCharacter::RemoveItemFromInventory(AGSPickup* Item)
+{
+	if (!Item || GetLocalRole() < ROLE_Authority)
+	{
+		return;
+	}
+
+	if (AGSWeapon* Weapon = Cast<AGSWeapon>(Item))
+	{
+		if (Weapon == CurrentWeapon)
+		{
+			SetCurrentWeapon(nullptr, CurrentWeapon);
+			// CurrentWeapon 不会复制给自主客户端
+			ClientSyncCurrentWeapon(nullptr);
+		}
+
+		Weapon->RemoveAbilities(AbilitySystemComponent);
+	}
+
+	if (LastTouchItem == Item)
+	{
+		LastTouchItem = nullptr;
+	}
+
+	if (Inventory.RemoveItem(Item))
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(AGSHeroCharacter, Inventory, this);
+	}
+}
+
 // Called when the game starts or when spawned
 void AGSHeroCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 	PlayerController = GetController<AGASPlayerController>();
+
+	// 倒地的角色可以被其他玩家救起，注册到交互索引中
+	if (UGSInteractableSubsystem* InteractableSubsystem = GetWorld()->GetSubsystem<UGSInteractableSubsystem>())
+	{
+		InteractableSubsystem->RegisterInteractable(this);
+	}
 }
 
-/**
- * @brief 如果背包中存在相同的武器类型，就说明有同类武器，返回 true.
- */
-bool AGSHeroCharacter::DoesWeaponExistInInventory(const AGSWeapon* InWeapon)
+void AGSHeroCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	//UE_LOG(LogTemp, Log, TEXT("%s InWeapon class %s"), *FString(__FUNCTION__), *InWeapon->GetClass()->GetName());
-	for (const AGSWeapon* Weapon : Inventory.Weapons)
+	if (UGSInteractableSubsystem* InteractableSubsystem = GetWorld()->GetSubsystem<UGSInteractableSubsystem>())
 	{
-		if (Weapon && InWeapon && Weapon->WeaponTag == InWeapon->WeaponTag)
-		{
-			return true;
-		}
+		InteractableSubsystem->UnregisterInteractable(this);
 	}
 
-	return false;
+	Super::EndPlay(EndPlayReason);
 }
 
-void AGSHeroCharacter::OnRep_Inventory()
+/**
+ * @brief 如果背包中存在相同的武器类型，就说明有同类武器，返回 true.
+ */
+bool AGSHeroCharacter::DoesWeaponExistInInventory(const AGSWeapon* InWeapon) const
+{
+	return InWeapon && Inventory.FindWeapon(InWeapon->WeaponTag) != nullptr;
+}
+
+void AGSHeroCharacter::OnInventoryItemAdded(AGSPickup* Item)
 {
-	if (GetLocalRole() == ROLE_AutonomousProxy && Inventory.Weapons.Num() > 0 && !CurrentWeapon)
+	Inventory.CacheItem(Item);
+
+	if (GetLocalRole() == ROLE_AutonomousProxy && Cast<AGSWeapon>(Item) && !CurrentWeapon)
 	{
 		// Since we don't replicate the CurrentWeapon to the owning client, this is a way to ask the Server to sync
 		// the CurrentWeapon after it's been spawned via replication from the Server.
@@ -216,6 +253,106 @@ void AGSHeroCharacter::OnRep_Inventory()
 	}
 }
 
+void AGSHeroCharacter::OnInventoryItemRemoved(AGSPickup* Item)
+{
+	Inventory.UncacheItem(Item);
+}
+
+void FGSHeroInventoryEntry::PreReplicatedRemove(const FGSHeroInventory& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnInventoryItemRemoved(Item);
+	}
+}
+
+void FGSHeroInventoryEntry::PostReplicatedAdd(const FGSHeroInventory& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnInventoryItemAdded(Item);
+	}
+}
+
+void FGSHeroInventoryEntry::PostReplicatedChange(const FGSHeroInventory& InArraySerializer)
+{
+	// 物品 Actor 晚于背包复制到达时，引用映射成功后会走到这里
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnInventoryItemAdded(Item);
+	}
+}
+
+void FGSHeroInventory::AddItem(AGSPickup* NewItem)
+{
+	FGSHeroInventoryEntry& Entry = Items.AddDefaulted_GetRef();
+	Entry.Item = NewItem;
+	MarkItemDirty(Entry);
+	CacheItem(NewItem);
+}
+
+bool FGSHeroInventory::RemoveItem(AGSPickup* InItem)
+{
+	const int32 Index = Items.IndexOfByPredicate([InItem](const FGSHeroInventoryEntry& Entry)
+	{
+		return Entry.Item == InItem;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Items.RemoveAtSwap(Index);
+	MarkArrayDirty();
+	UncacheItem(InItem);
+	return true;
+}
+
+AGSWeapon* FGSHeroInventory::FindWeapon(const FGameplayTag& WeaponTag) const
+{
+	AGSWeapon* const* Weapon = WeaponsByTag.Find(WeaponTag);
+	return Weapon ? *Weapon : nullptr;
+}
+
+void FGSHeroInventory::CacheItem(AGSPickup* InItem)
+{
+	if (!InItem)
+	{
+		return;
+	}
+
+	if (AGSWeapon* Weapon = Cast<AGSWeapon>(InItem))
+	{
+		Weapons.AddUnique(Weapon);
+		WeaponsByTag.Add(Weapon->WeaponTag, Weapon);
+	}
+	else
+	{
+		PickUpItems.AddUnique(InItem);
+	}
+}
+
+void FGSHeroInventory::UncacheItem(AGSPickup* InItem)
+{
+	if (!InItem)
+	{
+		return;
+	}
+
+	if (AGSWeapon* Weapon = Cast<AGSWeapon>(InItem))
+	{
+		Weapons.Remove(Weapon);
+		if (FindWeapon(Weapon->WeaponTag) == Weapon)
+		{
+			WeaponsByTag.Remove(Weapon->WeaponTag);
+		}
+	}
+	else
+	{
+		PickUpItems.Remove(InItem);
+	}
+}
+
 void AGSHeroCharacter::OnRep_CurrentWeapon(AGSWeapon* LastWeapon)
 {
 	bChangedWeaponLocally = false;
@@ -307,6 +444,13 @@ void AGSHeroCharacter::SetCurrentWeapon(AGSWeapon* NewWeapon, const AGSWeapon* L
 	{
 		// This will clear HUD, tags etc
 		// UnEquipCurrentWeapon();
+		if (AbilitySystemComponent)
+		{
+			AbilitySystemComponent->RemoveLooseGameplayTag(CurrentWeaponTag);
+		}
+
+		CurrentWeapon = nullptr;
+		CurrentWeaponTag = NoWeaponTag;
 	}
 }
 
@@ -404,7 +548,7 @@ void AGSHeroCharacter::OnOverlayStateChanged(EALSOverlayState PreviousState)
 		if (PreviousState == EALSOverlayState::Rifle || PreviousState == EALSOverlayState::PistolOneHanded ||
 			PreviousState == EALSOverlayState::PistolTwoHanded || PreviousState == EALSOverlayState::Bow)
 		{
-			if (CurrentWeapon->WeaponTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Equipped.Pistol")))
+			if (CurrentWeapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Pistol)
 			{
 				if (!(OverlayState == EALSOverlayState::PistolOneHanded && PreviousState ==
 					EALSOverlayState::PistolTwoHanded
@@ -414,11 +558,11 @@ void AGSHeroCharacter::OnOverlayStateChanged(EALSOverlayState PreviousState)
 					PistolMesh->SetVisibility(true);
 				}
 			}
-			else if (CurrentWeapon->WeaponTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Equipped.Rifle")))
+			else if (CurrentWeapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Rifle)
 			{
 				RifleMesh->SetVisibility(true);
 			}
-			else if (CurrentWeapon->WeaponTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Equipped.Bow")))
+			else if (CurrentWeapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Bow)
 			{
 				BowMesh->SetVisibility(true);
 			}
@@ -431,23 +575,20 @@ void AGSHeroCharacter::OnOverlayStateChanged(EALSOverlayState PreviousState)
 	{
 		for (const auto Weapon : Inventory.Weapons)
 		{
-			if (OverlayState == EALSOverlayState::Rifle && Weapon->WeaponTag == FGameplayTag::RequestGameplayTag(
-				FName("Weapon.Equipped.Rifle")))
+			if (OverlayState == EALSOverlayState::Rifle && Weapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Rifle)
 			{
 				// RifleMesh->SetVisibility(false);
 				SetCurrentWeapon(Weapon, CurrentWeapon);
 				break;
 			}
 			if ((OverlayState == EALSOverlayState::PistolTwoHanded || OverlayState ==
-				EALSOverlayState::PistolOneHanded) && Weapon->WeaponTag == FGameplayTag::RequestGameplayTag(
-				FName("Weapon.Equipped.Pistol")))
+				EALSOverlayState::PistolOneHanded) && Weapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Pistol)
 			{
 				// PistolMesh->SetVisibility(false);
 				SetCurrentWeapon(Weapon, CurrentWeapon);
 				break;
 			}
-			if (OverlayState == EALSOverlayState::Bow && Weapon->WeaponTag == FGameplayTag::RequestGameplayTag(
-				FName("Weapon.Equipped.Bow")))
+			if (OverlayState == EALSOverlayState::Bow && Weapon->WeaponTag == FGSGameplayTags::Get().Weapon_Equipped_Bow)
 			{
 				// PistolMesh->SetVisibility(false);
 				SetCurrentWeapon(Weapon, CurrentWeapon);
@@ -499,7 +640,7 @@ void AGSHeroCharacter::PreInteract_Implementation(AActor* InteractingActor, UPri
 		HasAuthority())
 	{
 		AbilitySystemComponent->TryActivateAbilitiesByTag(
-			FGameplayTagContainer(FGameplayTag::RequestGameplayTag("Ability.Revive")));
+			FGameplayTagContainer(FGSGameplayTags::Get().Ability_Revive));
 	}
 }
 
@@ -531,7 +672,7 @@ void AGSHeroCharacter::CancelInteraction_Implementation(UPrimitiveComponent* Int
 	if (IsValid(AbilitySystemComponent) && AbilitySystemComponent->HasMatchingGameplayTag(KnockedDownTag) &&
 		HasAuthority())
 	{
-		FGameplayTagContainer CancelTags(FGameplayTag::RequestGameplayTag("Ability.Revive"));
+		FGameplayTagContainer CancelTags(FGSGameplayTags::Get().Ability_Revive);
 		AbilitySystemComponent->CancelAbilities(&CancelTags);
 	}
 }
@@ -1,7 +1,17 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Game/AnimationSystem.h"
+#include "Game/GSGameplayTags.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, AnimationSystem, "AnimationSystem" );
+class FAnimationSystemModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		FGSGameplayTags::InitializeNativeTags();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FAnimationSystemModule, AnimationSystem, "AnimationSystem" );
 DEFINE_LOG_CATEGORY(LogHints);
@@ -3,3 +3,28 @@
 
 #include "Game/AnimationSystemGameModeBase.h"
 
+#include "Items/Projectiles/GSProjectileManager.h"
+#include "Kismet/GameplayStatics.h"
+
+AAnimationSystemGameModeBase::AAnimationSystemGameModeBase()
+{
+	ProjectileManagerClass = AGSProjectileManager::StaticClass();
+}
+
+void AAnimationSystemGameModeBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (ProjectileManagerClass)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		GetWorld()->SpawnActor<AGSProjectileManager>(ProjectileManagerClass, FTransform::Identity, SpawnParameters);
+	}
+
+	const FName LevelName(*UGameplayStatics::GetCurrentLevelName(this, true));
+	if (const FGSActorPoolManifest* Manifest = ActorPoolManifests.Find(LevelName))
+	{
+		GetWorld()->GetSubsystem<UGSActorPoolSubsystem>()->Prewarm(*Manifest);
+	}
+}
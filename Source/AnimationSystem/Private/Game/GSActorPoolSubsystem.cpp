@@ -0,0 +1,142 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Game/GSActorPoolSubsystem.h"
+
+#include "Characters/Heroes/GSHeroCharacter.h"
+#include "Game/AnimationSystem.h"
+#include "Items/Pickups/GSPickup.h"
+
+void UGSActorPoolSubsystem::Deinitialize()
+{
+	FreeActors.Empty();
+	ActiveActors.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGSActorPoolSubsystem::Prewarm(const FGSActorPoolManifest& Manifest)
+{
+	for (const FGSActorPoolEntry& Entry : Manifest.Entries)
+	{
+		PrewarmClass(Entry.ActorClass, Entry.Count);
+	}
+}
+
+void UGSActorPoolSubsystem::PrewarmClass(TSubclassOf<AGSPickup> ActorClass, int32 Count)
+{
+	if (!ActorClass || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	TArray<TWeakObjectPtr<AGSPickup>>& Free = FreeActors.FindOrAdd(ActorClass);
+	Free.Reserve(Count);
+
+	const FTransform PoolTransform(PoolLocation);
+	for (int32 Index = Free.Num(); Index < Count; ++Index)
+	{
+		if (AGSPickup* Actor = SpawnNew(ActorClass, PoolTransform, nullptr))
+		{
+			Actor->OnReleasedToPool();
+			Free.Add(Actor);
+		}
+	}
+}
+
+AGSPickup* UGSActorPoolSubsystem::SpawnPooled(TSubclassOf<AGSPickup> ActorClass, const FTransform& Transform,
+                                              AActor* Owner)
+{
+	if (!ActorClass || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return nullptr;
+	}
+
+	AGSPickup* Actor = nullptr;
+	if (TArray<TWeakObjectPtr<AGSPickup>>* Free = FreeActors.Find(ActorClass))
+	{
+		// 池中的 Actor 可能已经被别处销毁
+		while (!Actor && Free->Num() > 0)
+		{
+			Actor = Free->Pop(false).Get();
+			if (Actor && Actor->IsPendingKillPending())
+			{
+				Actor = nullptr;
+			}
+		}
+	}
+
+	if (Actor)
+	{
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		Actor->SetOwner(Owner);
+		Actor->OnAcquiredFromPool();
+	}
+	else
+	{
+		UE_LOG(LogHints, Verbose, TEXT("%s pool of %s is empty, spawning a new actor"), *FString(__FUNCTION__),
+		       *ActorClass->GetName());
+		Actor = SpawnNew(ActorClass, Transform, Owner);
+	}
+
+	if (Actor)
+	{
+		ActiveActors.Add(Actor);
+	}
+	return Actor;
+}
+
+void UGSActorPoolSubsystem::ReleaseToPool(AGSPickup* Actor)
+{
+	if (!Actor || !Actor->HasAuthority())
+	{
+		return;
+	}
+
+	ActiveActors.Remove(Actor);
+	ReturnActor(Actor);
+}
+
+void UGSActorPoolSubsystem::ReleaseAll()
+{
+	for (const TWeakObjectPtr<AGSPickup>& Actor : ActiveActors)
+	{
+		if (Actor.IsValid())
+		{
+			ReturnActor(Actor.Get());
+		}
+	}
+	ActiveActors.Reset();
+}
+
+int32 UGSActorPoolSubsystem::GetNumFree(TSubclassOf<AGSPickup> ActorClass) const
+{
+	const TArray<TWeakObjectPtr<AGSPickup>>* Free = FreeActors.Find(ActorClass);
+	return Free ? Free->Num() : 0;
+}
+
+AGSPickup* UGSActorPoolSubsystem::SpawnNew(UClass* ActorClass, const FTransform& Transform, AActor* Owner) const
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Owner;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AGSPickup>(ActorClass, Transform, SpawnParameters);
+}
+
+void UGSActorPoolSubsystem::ReturnActor(AGSPickup* Actor)
+{
+	if (Actor->IsPendingKillPending() || Actor->IsInPool())
+	{
+		return;
+	}
+
+	// 还在角色背包中的物品先移出背包，清除能力和当前武器，之后 OnReleasedToPool 会清空所有者
+	if (AGSHeroCharacter* Hero = Cast<AGSHeroCharacter>(Actor->GetOwner()))
+	{
+		Hero->RemoveItemFromInventory(Actor);
+	}
+
+	Actor->OnReleasedToPool();
+	Actor->SetActorLocation(PoolLocation, false, nullptr, ETeleportType::ResetPhysics);
+	FreeActors.FindOrAdd(Actor->GetClass()).Add(Actor);
+}
@@ -0,0 +1,90 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Game/GSGameplayTags.h"
+
+#include "GameplayTagsManager.h"
+#include "GameplayTagsSettings.h"
+#include "Game/AnimationSystem.h"
+
+FGSGameplayTags FGSGameplayTags::GameplayTags;
+
+void FGSGameplayTags::InitializeNativeTags()
+{
+	if (GameplayTags.bInitialized)
+	{
+		return;
+	}
+
+	GameplayTags.bInitialized = true;
+	GameplayTags.AddAllTags();
+	GameplayTags.ValidateAgainstConfig();
+}
+
+void FGSGameplayTags::AddAllTags()
+{
+	AddTag(Weapon_Equipped_None, "Weapon.Equipped.None");
+	AddTag(Weapon_Equipped_Pistol, "Weapon.Equipped.Pistol");
+	AddTag(Weapon_Equipped_Rifle, "Weapon.Equipped.Rifle");
+	AddTag(Weapon_Equipped_Bow, "Weapon.Equipped.Bow");
+
+	AddTag(Weapon_Ammo_None, "Weapon.Ammo.None");
+	AddTag(Weapon_Ammo_Rifle, "Weapon.Ammo.Rifle");
+	AddTag(Weapon_Ammo_Rocket, "Weapon.Ammo.Rocket");
+	AddTag(Weapon_Ammo_Shotgun, "Weapon.Ammo.Shotgun");
+
+	AddTag(Ability_Weapon, "Ability.Weapon");
+	AddTag(Ability_Weapon_IsChangingDelayReplication, "Ability.Weapon.IsChangingDelayReplication");
+	AddTag(Ability_Interaction, "Ability.Interaction");
+	AddTag(Ability_BlocksInteraction, "Ability.BlocksInteraction");
+	AddTag(Ability_Revive, "Ability.Revive");
+
+	AddTag(State_Dead, "State.Dead");
+	AddTag(State_KnockedDown, "State.KnockedDown");
+	AddTag(State_Interacting, "State.Interacting");
+	AddTag(State_InteractingRemoval, "State.InteractingRemoval");
+
+	AddTag(Data_Damage, "Data.Damage");
+	AddTag(Effect_Damage_HeadShot, "Effect.Damage.HeadShot");
+}
+
+void FGSGameplayTags::AddTag(FGameplayTag& OutTag, const ANSICHAR* TagName)
+{
+	OutTag = UGameplayTagsManager::Get().AddNativeGameplayTag(FName(TagName));
+	RegisteredTagNames.Add(FName(TagName));
+}
+
+void FGSGameplayTags::ValidateAgainstConfig() const
+{
+	const UGameplayTagsSettings* Settings = GetDefault<UGameplayTagsSettings>();
+
+	TArray<FString> ConfigTags;
+	ConfigTags.Reserve(Settings->GameplayTagList.Num());
+	for (const FGameplayTagTableRow& Row : Settings->GameplayTagList)
+	{
+		ConfigTags.Add(Row.Tag.ToString());
+	}
+
+	int32 MissingCount = 0;
+	for (const FName& TagName : RegisteredTagNames)
+	{
+		// 父 Tag 不会单独写在配置中，只要有子 Tag 就算声明过
+		const FString Name = TagName.ToString();
+		const FString ParentPrefix = Name + TEXT(".");
+		const bool bFound = ConfigTags.ContainsByPredicate([&Name, &ParentPrefix](const FString& ConfigTag)
+		{
+			return ConfigTag.Equals(Name, ESearchCase::IgnoreCase) || ConfigTag.StartsWith(ParentPrefix, ESearchCase::IgnoreCase);
+		});
+
+		if (!bFound)
+		{
+			UE_LOG(LogHints, Error, TEXT("%s Native gameplay tag %s is missing from DefaultGameplayTags.ini"), *FString(__FUNCTION__), *Name);
+			++MissingCount;
+		}
+	}
+
+	if (MissingCount > 0)
+	{
+		UE_LOG(LogHints, Fatal, TEXT("%s %d native gameplay tags are missing from DefaultGameplayTags.ini"), *FString(__FUNCTION__), MissingCount);
+	}
+}
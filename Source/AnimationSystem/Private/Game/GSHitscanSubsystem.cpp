@@ -0,0 +1,243 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Game/GSHitscanSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Characters/Heroes/GSHeroCharacter.h"
+#include "Game/GSGameplayTags.h"
+#include "Game/GSLagCompensationSubsystem.h"
+#include "Items/Weapons/GSWeapon.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitscan Resolve"), STAT_GSHitscanResolve, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Apply Damage"), STAT_GSHitscanApplyDamage, STATGROUP_Game);
+
+void UGSHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 角色由延迟补偿回溯，先确保它已经创建
+	Collection.InitializeDependency(UGSLagCompensationSubsystem::StaticClass());
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this, &UGSHitscanSubsystem::OnWorldPostActorTick);
+}
+
+void UGSHitscanSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	QueuedShots.Empty();
+	TracingShots.Empty();
+	PendingDamage.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGSHitscanSubsystem::QueueShot(AGSWeapon* Weapon, const FVector& Start, const FVector& Direction, float ShotTime)
+{
+	FHitscanShot& Shot = QueuedShots.AddDefaulted_GetRef();
+	Shot.Weapon = Weapon;
+	Shot.Start = Start;
+	Shot.Direction = Direction.GetSafeNormal();
+	Shot.ShotTime = ShotTime;
+}
+
+void UGSHitscanSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	// 上一帧发起的查询先结算，再为本帧的子弹发起新的查询
+	ResolveTracedShots();
+	ApplyAggregatedDamage();
+	StartTraces();
+}
+
+FCollisionObjectQueryParams UGSHitscanSubsystem::MakeWorldObjectParams()
+{
+	// 角色不在查询范围内，它们由延迟补偿的快照判断
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	ObjectParams.AddObjectTypesToQuery(ECC_Destructible);
+	return ObjectParams;
+}
+
+FCollisionQueryParams UGSHitscanSubsystem::MakeWorldQueryParams(const AGSWeapon* Weapon)
+{
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(GSHitscan), true, Weapon);
+	Params.AddIgnoredActor(Weapon->GetOwningCharacter());
+	Params.bReturnPhysicalMaterial = true;
+	return Params;
+}
+
+void UGSHitscanSubsystem::StartTraces()
+{
+	UWorld* World = GetWorld();
+	const FCollisionObjectQueryParams ObjectParams = MakeWorldObjectParams();
+
+	for (FHitscanShot& Shot : QueuedShots)
+	{
+		AGSWeapon* Weapon = Shot.Weapon.Get();
+		if (!Weapon)
+		{
+			continue;
+		}
+
+		const FVector End = Shot.Start + Shot.Direction * Weapon->GetHitscanRange();
+		Shot.TraceHandle = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Shot.Start, End, ObjectParams,
+		                                                     MakeWorldQueryParams(Weapon));
+		TracingShots.Add(Shot);
+	}
+
+	QueuedShots.Reset();
+}
+
+void UGSHitscanSubsystem::ResolveTracedShots()
+{
+	if (TracingShots.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GSHitscanResolve);
+
+	UWorld* World = GetWorld();
+	FTraceDatum TraceDatum;
+
+	for (const FHitscanShot& Shot : TracingShots)
+	{
+		if (World->QueryTraceData(Shot.TraceHandle, TraceDatum))
+		{
+			ResolveShot(Shot, TraceDatum.OutHits.Num() > 0 ? &TraceDatum.OutHits[0] : nullptr);
+			continue;
+		}
+
+		// 异步结果只在发起后的下一帧可以取到，取不到（比如句柄已过期）时同步补查一次，
+		// 不能当作没有遮挡，否则子弹会穿墙
+		const AGSWeapon* Weapon = Shot.Weapon.Get();
+		if (!Weapon)
+		{
+			continue;
+		}
+
+		FHitResult WorldHit;
+		const FVector End = Shot.Start + Shot.Direction * Weapon->GetHitscanRange();
+		const bool bHit = World->LineTraceSingleByObjectType(WorldHit, Shot.Start, End, MakeWorldObjectParams(),
+		                                                     MakeWorldQueryParams(Weapon));
+		ResolveShot(Shot, bHit ? &WorldHit : nullptr);
+	}
+
+	TracingShots.Reset();
+}
+
+void UGSHitscanSubsystem::ResolveShot(const FHitscanShot& Shot, const FHitResult* WorldHit)
+{
+	AGSWeapon* Weapon = Shot.Weapon.Get();
+	if (!Weapon)
+	{
+		return;
+	}
+
+	// 场景命中点之后的角色被挡住了
+	FGSLagCompensatedShot CharacterShot;
+	CharacterShot.Shooter = Weapon->GetOwningCharacter();
+	CharacterShot.Start = Shot.Start;
+	CharacterShot.Direction = Shot.Direction;
+	CharacterShot.Range = WorldHit ? WorldHit->Distance : Weapon->GetHitscanRange();
+	CharacterShot.ShotTime = Shot.ShotTime;
+
+	const UGSLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UGSLagCompensationSubsystem>();
+	FGSLagCompensatedHit CharacterHit;
+	if (LagCompensation && LagCompensation->TraceShot(CharacterShot, CharacterHit))
+	{
+		FHitResult HitResult(CharacterHit.HitActor, nullptr, CharacterHit.Location, -Shot.Direction);
+		HitResult.BoneName = CharacterHit.BoneName;
+		HitResult.Distance = CharacterHit.Distance;
+		HitResult.TraceStart = Shot.Start;
+		HitResult.TraceEnd = Shot.Start + Shot.Direction * CharacterShot.Range;
+		AddDamage(Weapon, CharacterHit.HitActor, CharacterHit.bHeadShot, HitResult);
+	}
+	else if (WorldHit && WorldHit->Actor.IsValid())
+	{
+		AddDamage(Weapon, WorldHit->Actor.Get(), false, *WorldHit);
+	}
+}
+
+void UGSHitscanSubsystem::AddDamage(AGSWeapon* Weapon, AActor* Target, bool bHeadShot, const FHitResult& HitResult)
+{
+	// 只有拥有 ASC 的目标才能受到伤害
+	if (!UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target))
+	{
+		return;
+	}
+
+	FAggregatedDamage* Entry = PendingDamage.FindByPredicate([Weapon, Target](const FAggregatedDamage& Damage)
+	{
+		return Damage.Weapon.Get() == Weapon && Damage.Target.Get() == Target;
+	});
+
+	if (!Entry)
+	{
+		Entry = &PendingDamage.AddDefaulted_GetRef();
+		Entry->Weapon = Weapon;
+		Entry->Target = Target;
+		Entry->HitResult = HitResult;
+	}
+
+	Entry->Damage += Weapon->GetDamageStrength();
+	Entry->bHeadShot |= bHeadShot && Weapon->CanHeadShot();
+}
+
+void UGSHitscanSubsystem::ApplyAggregatedDamage()
+{
+	if (PendingDamage.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GSHitscanApplyDamage);
+
+	for (const FAggregatedDamage& Damage : PendingDamage)
+	{
+		AGSWeapon* Weapon = Damage.Weapon.Get();
+		AActor* Target = Damage.Target.Get();
+		AGSHeroCharacter* Shooter = Weapon ? Weapon->GetOwningCharacter() : nullptr;
+		if (!Target || !Shooter || !Weapon->GetHitscanDamageEffect())
+		{
+			continue;
+		}
+
+		UAbilitySystemComponent* SourceASC = Shooter->GetAbilitySystemComponent();
+		UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target);
+		if (!SourceASC || !TargetASC)
+		{
+			continue;
+		}
+
+		FGameplayEffectContextHandle Context = SourceASC->MakeEffectContext();
+		Context.AddSourceObject(Weapon);
+		Context.AddHitResult(Damage.HitResult);
+
+		FGameplayEffectSpecHandle Spec = SourceASC->MakeOutgoingSpec(Weapon->GetHitscanDamageEffect(), 1.f, Context);
+		if (!Spec.IsValid())
+		{
+			continue;
+		}
+
+		Spec.Data->SetSetByCallerMagnitude(FGSGameplayTags::Get().Data_Damage, Damage.Damage);
+		if (Damage.bHeadShot)
+		{
+			Spec.Data->DynamicAssetTags.AddTag(FGSGameplayTags::Get().Effect_Damage_HeadShot);
+		}
+
+		SourceASC->ApplyGameplayEffectSpecToTarget(*Spec.Data.Get(), TargetASC);
+	}
+
+	PendingDamage.Reset();
+}
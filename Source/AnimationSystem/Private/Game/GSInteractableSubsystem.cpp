@@ -0,0 +1,376 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Game/GSInteractableSubsystem.h"
+
+#include "Characters/Abilities/GSInteractable.h"
+#include "Components/PrimitiveComponent.h"
+#include "Game/AnimationSystem.h"
+
+void UGSInteractableSubsystem::Deinitialize()
+{
+	for (const TPair<TWeakObjectPtr<UPrimitiveComponent>, FIntVector>& Pair : ComponentCells)
+	{
+		if (UPrimitiveComponent* Component = Pair.Key.Get())
+		{
+			Component->TransformUpdated.RemoveAll(this);
+		}
+	}
+
+	for (const TPair<int32, FProximityWatcher>& Pair : Watchers)
+	{
+		if (USceneComponent* RootComponent = Pair.Value.RootComponent.Get())
+		{
+			RootComponent->TransformUpdated.Remove(Pair.Value.TransformUpdatedHandle);
+		}
+	}
+
+	Cells.Empty();
+	ComponentCells.Empty();
+	Watchers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGSInteractableSubsystem::RegisterInteractable(AActor* Actor)
+{
+	if (!Actor || !Actor->Implements<UGSInteractable>())
+	{
+		return;
+	}
+
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [this](UPrimitiveComponent* Component)
+	{
+		AddComponent(Component);
+	});
+}
+
+void UGSInteractableSubsystem::UnregisterInteractable(AActor* Actor)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [this](UPrimitiveComponent* Component)
+	{
+		RemoveComponent(Component);
+	});
+}
+
+bool UGSInteractableSubsystem::FindBestInteractable(const FGSInteractableQuery& Query,
+                                                    FGSInteractableCandidate& OutCandidate) const
+{
+	const float TanHalfAngle = FMath::Tan(FMath::DegreesToRadians(Query.ConeHalfAngle));
+	const float ScanExtent = Query.MaxRange + MaxBoundsRadius;
+	const FIntVector MinCell = GetCell(Query.RangeCenter - FVector(ScanExtent));
+	const FIntVector MaxCell = GetCell(Query.RangeCenter + FVector(ScanExtent));
+
+	bool bFound = false;
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<TWeakObjectPtr<UPrimitiveComponent>>* Cell = Cells.Find(FIntVector(X, Y, Z));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (const TWeakObjectPtr<UPrimitiveComponent>& WeakComponent : *Cell)
+				{
+					UPrimitiveComponent* Component = WeakComponent.Get();
+					if (!Component || !Component->IsQueryCollisionEnabled()
+						|| Component->GetCollisionResponseToChannel(COLLISION_INTERACTABLE) != ECR_Overlap)
+					{
+						continue;
+					}
+
+					AActor* Actor = Component->GetOwner();
+					if (!Actor || Actor == Query.IgnoreActor)
+					{
+						continue;
+					}
+
+					const FVector Center = Component->Bounds.Origin;
+					const float Radius = Component->Bounds.SphereRadius;
+
+					// 视线与包围球最近的点
+					const FVector ToCenter = Center - Query.ViewStart;
+					const float Along = FVector::DotProduct(ToCenter, Query.ViewDir);
+					if (Along < -Radius || (bFound && Along >= OutCandidate.Distance))
+					{
+						continue;
+					}
+
+					const FVector ClosestOnRay = Query.ViewStart + Query.ViewDir * Along;
+					const float PerpDistance = FVector::Dist(ClosestOnRay, Center);
+					if (PerpDistance > Radius + FMath::Max(Along, 0.f) * TanHalfAngle)
+					{
+						continue;
+					}
+
+					FVector HitLocation = ClosestOnRay;
+					if (PerpDistance > Radius)
+					{
+						HitLocation = Center + (ClosestOnRay - Center) * (Radius / PerpDistance);
+					}
+
+					if (FVector::DistSquared(Query.RangeCenter, HitLocation) > FMath::Square(Query.MaxRange))
+					{
+						continue;
+					}
+
+					if (!IGSInteractable::Execute_IsAvailableForInteraction(Actor, Component))
+					{
+						continue;
+					}
+
+					OutCandidate.Component = Component;
+					OutCandidate.Location = HitLocation;
+					OutCandidate.Distance = Along;
+					bFound = true;
+				}
+			}
+		}
+	}
+
+	return bFound;
+}
+
+int32 UGSInteractableSubsystem::AddProximityWatcher(AActor* WatcherActor, float Radius,
+                                                    FGSInteractableProximityDelegate Delegate, bool& bOutHasNearby)
+{
+	bOutHasNearby = false;
+	if (!WatcherActor || !WatcherActor->GetRootComponent())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 WatcherId = NextWatcherId++;
+	FProximityWatcher& Watcher = Watchers.Add(WatcherId);
+	Watcher.Actor = WatcherActor;
+	Watcher.RootComponent = WatcherActor->GetRootComponent();
+	Watcher.Delegate = MoveTemp(Delegate);
+	Watcher.Cell = GetCell(WatcherActor->GetActorLocation());
+	Watcher.Radius = Radius;
+	Watcher.CellRadius = GetWatcherCellRadius(Radius);
+	Watcher.TransformUpdatedHandle = WatcherActor->GetRootComponent()->TransformUpdated.AddUObject(
+		this, &UGSInteractableSubsystem::OnWatcherTransformUpdated, WatcherId);
+
+	// 初始状态直接返回，不通过回调
+	Watcher.bHasNearby = HasNearbyInteractable(Watcher);
+	bOutHasNearby = Watcher.bHasNearby;
+
+	return WatcherId;
+}
+
+void UGSInteractableSubsystem::RemoveProximityWatcher(int32 WatcherId)
+{
+	FProximityWatcher Watcher;
+	if (!Watchers.RemoveAndCopyValue(WatcherId, Watcher))
+	{
+		return;
+	}
+
+	if (USceneComponent* RootComponent = Watcher.RootComponent.Get())
+	{
+		RootComponent->TransformUpdated.Remove(Watcher.TransformUpdatedHandle);
+	}
+}
+
+bool UGSInteractableSubsystem::HasNearbyInteractable(const FProximityWatcher& Watcher) const
+{
+	const AActor* WatcherActor = Watcher.Actor.Get();
+
+	for (int32 X = -Watcher.CellRadius; X <= Watcher.CellRadius; ++X)
+	{
+		for (int32 Y = -Watcher.CellRadius; Y <= Watcher.CellRadius; ++Y)
+		{
+			for (int32 Z = -Watcher.CellRadius; Z <= Watcher.CellRadius; ++Z)
+			{
+				const TArray<TWeakObjectPtr<UPrimitiveComponent>>* Cell = Cells.Find(Watcher.Cell + FIntVector(X, Y, Z));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (const TWeakObjectPtr<UPrimitiveComponent>& WeakComponent : *Cell)
+				{
+					// 忽略自身以及自己背包里的物品
+					const UPrimitiveComponent* Component = WeakComponent.Get();
+					const AActor* Owner = Component ? Component->GetOwner() : nullptr;
+					if (Owner && Owner != WatcherActor && Owner->GetOwner() != WatcherActor)
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+void UGSInteractableSubsystem::UpdateWatcher(int32 WatcherId)
+{
+	FProximityWatcher* Watcher = Watchers.Find(WatcherId);
+	if (!Watcher)
+	{
+		return;
+	}
+
+	const bool bHasNearby = HasNearbyInteractable(*Watcher);
+	if (bHasNearby != Watcher->bHasNearby)
+	{
+		Watcher->bHasNearby = bHasNearby;
+		// 回调中可能会移除监听，复制一份再执行
+		const FGSInteractableProximityDelegate Delegate = Watcher->Delegate;
+		Delegate.ExecuteIfBound(bHasNearby);
+	}
+}
+
+void UGSInteractableSubsystem::NotifyWatchersOfCellChange(const FIntVector& Cell)
+{
+	if (Watchers.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<8>> AffectedWatchers;
+	for (const TPair<int32, FProximityWatcher>& Pair : Watchers)
+	{
+		const FIntVector Offset = Cell - Pair.Value.Cell;
+		if (FMath::Abs(Offset.X) <= Pair.Value.CellRadius && FMath::Abs(Offset.Y) <= Pair.Value.CellRadius
+			&& FMath::Abs(Offset.Z) <= Pair.Value.CellRadius)
+		{
+			AffectedWatchers.Add(Pair.Key);
+		}
+	}
+
+	for (const int32 WatcherId : AffectedWatchers)
+	{
+		UpdateWatcher(WatcherId);
+	}
+}
+
+void UGSInteractableSubsystem::OnWatcherTransformUpdated(USceneComponent* UpdatedComponent,
+                                                         EUpdateTransformFlags UpdateTransformFlags,
+                                                         ETeleportType Teleport, int32 WatcherId)
+{
+	FProximityWatcher* Watcher = Watchers.Find(WatcherId);
+	if (!Watcher)
+	{
+		return;
+	}
+
+	// 只有跨过单元边界时才需要重新计算
+	const FIntVector NewCell = GetCell(UpdatedComponent->GetComponentLocation());
+	if (NewCell != Watcher->Cell)
+	{
+		Watcher->Cell = NewCell;
+		UpdateWatcher(WatcherId);
+	}
+}
+
+FIntVector UGSInteractableSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize),
+	                  FMath::FloorToInt(Location.Z / CellSize));
+}
+
+int32 UGSInteractableSubsystem::GetWatcherCellRadius(float Radius) const
+{
+	return FMath::Max(FMath::CeilToInt((Radius + MaxBoundsRadius) / CellSize), 1);
+}
+
+void UGSInteractableSubsystem::UpdateMaxBoundsRadius(const UPrimitiveComponent* Component)
+{
+	if (Component->Bounds.SphereRadius <= MaxBoundsRadius)
+	{
+		return;
+	}
+
+	MaxBoundsRadius = Component->Bounds.SphereRadius;
+	for (TPair<int32, FProximityWatcher>& Pair : Watchers)
+	{
+		Pair.Value.CellRadius = GetWatcherCellRadius(Pair.Value.Radius);
+	}
+}
+
+void UGSInteractableSubsystem::AddComponent(UPrimitiveComponent* Component)
+{
+	if (ComponentCells.Contains(Component))
+	{
+		return;
+	}
+
+	UpdateMaxBoundsRadius(Component);
+
+	const FIntVector Cell = GetCell(Component->Bounds.Origin);
+	Cells.FindOrAdd(Cell).Add(Component);
+	ComponentCells.Add(Component, Cell);
+	Component->TransformUpdated.AddUObject(this, &UGSInteractableSubsystem::OnComponentTransformUpdated);
+
+	NotifyWatchersOfCellChange(Cell);
+}
+
+void UGSInteractableSubsystem::RemoveComponent(UPrimitiveComponent* Component)
+{
+	FIntVector Cell;
+	if (!ComponentCells.RemoveAndCopyValue(Component, Cell))
+	{
+		return;
+	}
+
+	Component->TransformUpdated.RemoveAll(this);
+	if (TArray<TWeakObjectPtr<UPrimitiveComponent>>* CellComponents = Cells.Find(Cell))
+	{
+		CellComponents->RemoveSingleSwap(Component);
+		if (CellComponents->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+
+	NotifyWatchersOfCellChange(Cell);
+}
+
+void UGSInteractableSubsystem::OnComponentTransformUpdated(USceneComponent* UpdatedComponent,
+                                                           EUpdateTransformFlags UpdateTransformFlags,
+                                                           ETeleportType Teleport)
+{
+	UPrimitiveComponent* Component = Cast<UPrimitiveComponent>(UpdatedComponent);
+	FIntVector* OldCell = ComponentCells.Find(Component);
+	if (!OldCell)
+	{
+		return;
+	}
+
+	// 布娃娃等情况下包围球会变大
+	UpdateMaxBoundsRadius(Component);
+
+	const FIntVector NewCell = GetCell(Component->Bounds.Origin);
+	if (NewCell == *OldCell)
+	{
+		return;
+	}
+
+	if (TArray<TWeakObjectPtr<UPrimitiveComponent>>* CellComponents = Cells.Find(*OldCell))
+	{
+		CellComponents->RemoveSingleSwap(Component);
+		if (CellComponents->Num() == 0)
+		{
+			Cells.Remove(*OldCell);
+		}
+	}
+
+	const FIntVector PreviousCell = *OldCell;
+	Cells.FindOrAdd(NewCell).Add(Component);
+	*OldCell = NewCell;
+
+	NotifyWatchersOfCellChange(PreviousCell);
+	NotifyWatchersOfCellChange(NewCell);
+}
@@ -0,0 +1,333 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Game/GSLagCompensationSubsystem.h"
+
+#include "Characters/GSCharacterBase.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerState.h"
+
+DECLARE_CYCLE_STAT(TEXT("LagCompensation Record"), STAT_GSLagCompensationRecord, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("LagCompensation Validate"), STAT_GSLagCompensationValidate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LagCompensation Shots"), STAT_GSLagCompensationShots, STATGROUP_Game);
+
+namespace
+{
+	// 射线与球体相交，返回沿射线的进入距离
+	bool IntersectRaySphere(const FVector& Start, const FVector& Direction, float Range, const FVector& Center,
+	                        float Radius, float& OutDistance)
+	{
+		const FVector ToCenter = Center - Start;
+		const float Along = FVector::DotProduct(ToCenter, Direction);
+		const float PerpSquared = ToCenter.SizeSquared() - Along * Along;
+		const float RadiusSquared = Radius * Radius;
+		if (PerpSquared > RadiusSquared)
+		{
+			return false;
+		}
+
+		const float Entry = Along - FMath::Sqrt(RadiusSquared - PerpSquared);
+		OutDistance = FMath::Max(Entry, 0.f);
+		return Along + Radius >= 0.f && OutDistance <= Range;
+	}
+}
+
+UGSLagCompensationSubsystem::UGSLagCompensationSubsystem()
+{
+	// UE4 人体骨骼，头部单独判断爆头
+	Hitboxes.Add({FName("head"), 14.f, true});
+	Hitboxes.Add({FName("neck_01"), 10.f, false});
+	Hitboxes.Add({FName("spine_03"), 24.f, false});
+	Hitboxes.Add({FName("spine_01"), 20.f, false});
+	Hitboxes.Add({FName("pelvis"), 22.f, false});
+	// 四肢按关节放球，胶囊体只用来粗略剔除，命中必须落在某个球上
+	Hitboxes.Add({FName("lowerarm_l"), 9.f, false});
+	Hitboxes.Add({FName("lowerarm_r"), 9.f, false});
+	Hitboxes.Add({FName("calf_l"), 12.f, false});
+	Hitboxes.Add({FName("calf_r"), 12.f, false});
+	Hitboxes.Add({FName("foot_l"), 10.f, false});
+	Hitboxes.Add({FName("foot_r"), 10.f, false});
+
+	// 快照按 MaxHitboxes 分配，超出的命中盒会被悄悄丢掉
+	check(Hitboxes.Num() <= MaxHitboxes);
+}
+
+void UGSLagCompensationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this, &UGSLagCompensationSubsystem::OnWorldPostActorTick);
+}
+
+void UGSLagCompensationSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Histories.Empty();
+	PendingShots.Empty();
+	ValidatingShots.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGSLagCompensationSubsystem::RegisterCharacter(AGSCharacterBase* Character)
+{
+	if (!Character || !Character->HasAuthority() || FindHistory(Character))
+	{
+		return;
+	}
+
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+	// 专用服务器默认不刷新骨骼，回溯骨骼命中盒需要真实的姿势
+	if (Mesh && GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+
+	FCharacterHistory& History = Histories.AddDefaulted_GetRef();
+	History.Character = Character;
+	History.Frames.SetNum(HistorySize);
+
+	const int32 NumHitboxes = FMath::Min(Hitboxes.Num(), MaxHitboxes);
+	for (int32 Index = 0; Index < MaxHitboxes; ++Index)
+	{
+		History.BoneIndices[Index] = Mesh && Index < NumHitboxes ? Mesh->GetBoneIndex(Hitboxes[Index].BoneName) : INDEX_NONE;
+	}
+}
+
+void UGSLagCompensationSubsystem::UnregisterCharacter(AGSCharacterBase* Character)
+{
+	for (int32 Index = 0; Index < Histories.Num(); ++Index)
+	{
+		if (Histories[Index].Character.Get() == Character)
+		{
+			Histories.RemoveAtSwap(Index);
+			return;
+		}
+	}
+}
+
+void UGSLagCompensationSubsystem::QueueShot(const FGSLagCompensatedShot& Shot,
+                                            const FGSLagCompensatedShotDelegate& OnValidated)
+{
+	FPendingShot& PendingShot = PendingShots.AddDefaulted_GetRef();
+	PendingShot.Shot = Shot;
+	PendingShot.Shot.Direction = Shot.Direction.GetSafeNormal();
+	PendingShot.OnValidated = OnValidated;
+}
+
+float UGSLagCompensationSubsystem::GetRewindTime(const AController* ShooterController) const
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	const APlayerState* PlayerState = ShooterController ? ShooterController->PlayerState : nullptr;
+	if (!PlayerState || ShooterController->IsLocalController())
+	{
+		return Now;
+	}
+
+	// ExactPing 是往返时间，单位毫秒
+	const float Latency = PlayerState->ExactPing * 0.001f * 0.5f + InterpolationDelay;
+	return Now - FMath::Clamp(Latency, 0.f, MaxRewindTime);
+}
+
+void UGSLagCompensationSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld() || (Histories.Num() == 0 && PendingShots.Num() == 0))
+	{
+		return;
+	}
+
+	// 先记录本帧，再验证本帧收到的所有射击
+	RecordSnapshots(InWorld->GetTimeSeconds());
+	ValidatePendingShots();
+}
+
+void UGSLagCompensationSubsystem::RecordSnapshots(float Time)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GSLagCompensationRecord);
+
+	for (FCharacterHistory& History : Histories)
+	{
+		const AGSCharacterBase* Character = History.Character.Get();
+		if (!Character)
+		{
+			continue;
+		}
+
+		History.Head = (History.Head + 1) % History.Frames.Num();
+		History.Count = FMath::Min(History.Count + 1, History.Frames.Num());
+
+		FHitboxSnapshot& Snapshot = History.Frames[History.Head];
+		Snapshot.Time = Time;
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		Snapshot.CapsuleCenter = Capsule->GetComponentLocation();
+		Snapshot.CapsuleHalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+		Snapshot.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+
+		const USkeletalMeshComponent* Mesh = Character->GetMesh();
+		for (int32 Index = 0; Index < MaxHitboxes; ++Index)
+		{
+			const int32 BoneIndex = History.BoneIndices[Index];
+			Snapshot.BoneLocations[Index] = BoneIndex != INDEX_NONE
+				                                ? Mesh->GetBoneTransform(BoneIndex).GetLocation()
+				                                : Snapshot.CapsuleCenter;
+		}
+	}
+}
+
+void UGSLagCompensationSubsystem::ValidatePendingShots()
+{
+	if (PendingShots.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GSLagCompensationValidate);
+	INC_DWORD_STAT_BY(STAT_GSLagCompensationShots, PendingShots.Num());
+
+	// 回调中可能继续开枪，新加入的射击留到下一帧。两个队列交替使用，不会每帧重新分配
+	Swap(PendingShots, ValidatingShots);
+
+	for (const FPendingShot& PendingShot : ValidatingShots)
+	{
+		FGSLagCompensatedHit Hit;
+		TraceShot(PendingShot.Shot, Hit);
+		PendingShot.OnValidated.ExecuteIfBound(Hit);
+	}
+
+	ValidatingShots.Reset();
+}
+
+bool UGSLagCompensationSubsystem::TraceShot(const FGSLagCompensatedShot& Shot, FGSLagCompensatedHit& OutHit) const
+{
+	OutHit = FGSLagCompensatedHit();
+	FHitboxSnapshot Snapshot;
+
+	// 射线起点必须在开枪角色当时的位置附近
+	const FCharacterHistory* ShooterHistory = FindHistory(Shot.Shooter);
+	if (ShooterHistory && ShooterHistory->Count > 0)
+	{
+		GetSnapshotAtTime(*ShooterHistory, Shot.ShotTime, Snapshot);
+		const float MaxOffset = MaxShotStartOffset + Snapshot.CapsuleHalfHeight;
+		if (FVector::DistSquared(Shot.Start, Snapshot.CapsuleCenter) > FMath::Square(MaxOffset))
+		{
+			return false;
+		}
+	}
+
+	for (const FCharacterHistory& History : Histories)
+	{
+		AGSCharacterBase* Character = History.Character.Get();
+		if (!Character || Character == Shot.Shooter || History.Count == 0)
+		{
+			continue;
+		}
+
+		GetSnapshotAtTime(History, Shot.ShotTime, Snapshot);
+
+		FGSLagCompensatedHit Hit;
+		if (TraceSnapshot(Shot, Snapshot, Hit) && (!OutHit.bHit || Hit.Distance < OutHit.Distance))
+		{
+			Hit.HitActor = Character;
+			OutHit = Hit;
+		}
+	}
+
+	return OutHit.bHit;
+}
+
+void UGSLagCompensationSubsystem::GetSnapshotAtTime(const FCharacterHistory& History, float Time,
+                                                    FHitboxSnapshot& OutSnapshot) const
+{
+	const int32 NumFrames = History.Frames.Num();
+
+	// 从最新的一帧往前找第一帧不晚于 Time 的快照
+	int32 Newer = History.Head;
+	for (int32 Step = 1; Step < History.Count; ++Step)
+	{
+		const int32 Older = (History.Head - Step + NumFrames) % NumFrames;
+		const FHitboxSnapshot& OlderFrame = History.Frames[Older];
+		if (OlderFrame.Time <= Time)
+		{
+			const FHitboxSnapshot& NewerFrame = History.Frames[Newer];
+			const float Span = NewerFrame.Time - OlderFrame.Time;
+			const float Alpha = Span > KINDA_SMALL_NUMBER ? FMath::Clamp((Time - OlderFrame.Time) / Span, 0.f, 1.f) : 1.f;
+
+			OutSnapshot.Time = Time;
+			OutSnapshot.CapsuleCenter = FMath::Lerp(OlderFrame.CapsuleCenter, NewerFrame.CapsuleCenter, Alpha);
+			OutSnapshot.CapsuleHalfHeight = FMath::Lerp(OlderFrame.CapsuleHalfHeight, NewerFrame.CapsuleHalfHeight, Alpha);
+			OutSnapshot.CapsuleRadius = FMath::Lerp(OlderFrame.CapsuleRadius, NewerFrame.CapsuleRadius, Alpha);
+			for (int32 Index = 0; Index < MaxHitboxes; ++Index)
+			{
+				OutSnapshot.BoneLocations[Index] = FMath::Lerp(OlderFrame.BoneLocations[Index],
+				                                               NewerFrame.BoneLocations[Index], Alpha);
+			}
+			return;
+		}
+		Newer = Older;
+	}
+
+	// Time 比最新的帧还晚，或者比保存的最早一帧还早
+	OutSnapshot = History.Frames[Time >= History.Frames[History.Head].Time ? History.Head : Newer];
+}
+
+bool UGSLagCompensationSubsystem::TraceSnapshot(const FGSLagCompensatedShot& Shot, const FHitboxSnapshot& Snapshot,
+                                                FGSLagCompensatedHit& OutHit) const
+{
+	// 先和胶囊体的轴线比较，没碰到胶囊体就不用看骨骼。
+	// 胶囊体比身体宽，只碰到胶囊体、没碰到任何骨骼球的射线不算命中
+	const FVector Axis(0.f, 0.f, Snapshot.CapsuleHalfHeight - Snapshot.CapsuleRadius);
+	const FVector End = Shot.Start + Shot.Direction * Shot.Range;
+	FVector OnRay;
+	FVector OnAxis;
+	FMath::SegmentDistToSegmentSafe(Shot.Start, End, Snapshot.CapsuleCenter - Axis, Snapshot.CapsuleCenter + Axis,
+	                                OnRay, OnAxis);
+	if (FVector::DistSquared(OnRay, OnAxis) > FMath::Square(Snapshot.CapsuleRadius))
+	{
+		return false;
+	}
+
+	const int32 NumHitboxes = FMath::Min(Hitboxes.Num(), MaxHitboxes);
+	bool bHitBone = false;
+	for (int32 Index = 0; Index < NumHitboxes; ++Index)
+	{
+		const FGSLagCompensationHitbox& Hitbox = Hitboxes[Index];
+		float Distance;
+		if (IntersectRaySphere(Shot.Start, Shot.Direction, Shot.Range, Snapshot.BoneLocations[Index], Hitbox.Radius,
+		                       Distance) && (!OutHit.bHit || Distance < OutHit.Distance))
+		{
+			bHitBone = true;
+			OutHit.bHit = true;
+			OutHit.BoneName = Hitbox.BoneName;
+			OutHit.Distance = Distance;
+			OutHit.bHeadShot = Hitbox.bIsHead;
+		}
+	}
+
+	if (!bHitBone)
+	{
+		return false;
+	}
+
+	OutHit.Location = Shot.Start + Shot.Direction * OutHit.Distance;
+	return true;
+}
+
+const UGSLagCompensationSubsystem::FCharacterHistory* UGSLagCompensationSubsystem::FindHistory(
+	const AActor* Actor) const
+{
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	return Histories.FindByPredicate([Actor](const FCharacterHistory& History)
+	{
+		return History.Character.Get() == Actor;
+	});
+}
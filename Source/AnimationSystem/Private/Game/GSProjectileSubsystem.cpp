@@ -0,0 +1,330 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Game/GSProjectileSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Engine/World.h"
+#include "Game/AnimationSystem.h"
+#include "Game/GSGameplayTags.h"
+#include "GameFramework/GameStateBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Simulate"), STAT_GSProjectileSimulate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles In Flight"), STAT_GSProjectilesInFlight, STATGROUP_Game);
+
+void UGSProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this, &UGSProjectileSubsystem::OnWorldPostActorTick);
+}
+
+void UGSProjectileSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Ids.Empty();
+	Types.Empty();
+	Positions.Empty();
+	Velocities.Empty();
+	Ages.Empty();
+	Instigators.Empty();
+	PendingDamage.Empty();
+	PendingImpacts.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGSProjectileSubsystem::FireProjectiles(AActor* Instigator, uint8 Type, FVector Origin, FVector Direction,
+                                             int32 Count, float SpreadAngle)
+{
+	AGSProjectileManager* ProjectileManager = Manager.Get();
+	if (!ProjectileManager || !ProjectileManager->HasAuthority())
+	{
+		UE_LOG(LogHints, Error, TEXT("%s needs a ProjectileManager on the server"), *FString(__FUNCTION__));
+		return;
+	}
+
+	FGSProjectileVolley Volley;
+	Volley.Instigator = Instigator;
+	Volley.Origin = Origin;
+	Volley.Direction = Direction.GetSafeNormal();
+	Volley.SpreadAngle = SpreadAngle;
+	Volley.Seed = FMath::Rand();
+	Volley.FirstId = NextProjectileId;
+	Volley.ServerTime = GetWorld()->GetTimeSeconds();
+	Volley.Type = Type;
+	Volley.Count = static_cast<uint8>(FMath::Clamp(Count, 1, 255));
+
+	NextProjectileId += Volley.Count;
+
+	SpawnVolley(Volley);
+	ProjectileManager->MulticastSpawnVolley(Volley);
+}
+
+void UGSProjectileSubsystem::SpawnVolley(const FGSProjectileVolley& Volley)
+{
+	const AGSProjectileManager* ProjectileManager = Manager.Get();
+	const FGSProjectileType* Type = ProjectileManager ? ProjectileManager->GetProjectileType(Volley.Type) : nullptr;
+	if (!Type)
+	{
+		return;
+	}
+
+	// 客户端补上从服务器发射到收到事件之间的飞行时间，这段不做碰撞，命中由服务器的事件处理
+	float Elapsed = 0.f;
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (GameState && !ProjectileManager->HasAuthority())
+	{
+		Elapsed = FMath::Clamp(GameState->GetServerWorldTimeSeconds() - Volley.ServerTime, 0.f, Type->Lifetime);
+	}
+
+	const FVector Acceleration(0.f, 0.f, GetWorld()->GetGravityZ() * Type->GravityScale);
+	const float SpreadRadians = FMath::DegreesToRadians(Volley.SpreadAngle);
+
+	const int32 NewNum = Ids.Num() + Volley.Count;
+	Ids.Reserve(NewNum);
+	Types.Reserve(NewNum);
+	Positions.Reserve(NewNum);
+	Velocities.Reserve(NewNum);
+	Ages.Reserve(NewNum);
+	Instigators.Reserve(NewNum);
+
+	for (int32 Index = 0; Index < Volley.Count; ++Index)
+	{
+		// 和服务器用同样的种子得到同样的方向
+		FRandomStream Stream(Volley.Seed + Index);
+		const FVector Direction = SpreadRadians > 0.f ? Stream.VRandCone(Volley.Direction, SpreadRadians) : FVector(Volley.Direction);
+		const FVector Velocity = Direction * Type->Speed;
+
+		Ids.Add(Volley.FirstId + Index);
+		Types.Add(Volley.Type);
+		Positions.Add(Volley.Origin + Velocity * Elapsed + 0.5f * Acceleration * Elapsed * Elapsed);
+		Velocities.Add(Velocity + Acceleration * Elapsed);
+		Ages.Add(Elapsed);
+		Instigators.Add(Volley.Instigator);
+	}
+}
+
+void UGSProjectileSubsystem::ApplyRemoteImpacts(const TArray<FGSProjectileImpact>& Impacts)
+{
+	AGSProjectileManager* ProjectileManager = Manager.Get();
+
+	for (const FGSProjectileImpact& Impact : Impacts)
+	{
+		// 本地已经命中或消失的就不用处理了
+		const int32 Index = Ids.Find(Impact.Id);
+		if (Index == INDEX_NONE)
+		{
+			continue;
+		}
+
+		RemoveProjectile(Index);
+		if (ProjectileManager)
+		{
+			ProjectileManager->OnProjectileImpact(Impact.Type, Impact.Location, Impact.Normal);
+		}
+	}
+}
+
+void UGSProjectileSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld() || !Manager.IsValid())
+	{
+		return;
+	}
+
+	if (Ids.Num() > 0)
+	{
+		Simulate(DeltaSeconds);
+	}
+
+	AGSProjectileManager* ProjectileManager = Manager.Get();
+	if (ProjectileManager->HasAuthority())
+	{
+		ApplyAggregatedDamage();
+
+		if (PendingImpacts.Num() > 0)
+		{
+			ProjectileManager->MulticastImpacts(PendingImpacts);
+			PendingImpacts.Reset();
+		}
+	}
+
+	ProjectileManager->UpdateInstances(Types, Positions, Velocities);
+}
+
+void UGSProjectileSubsystem::Simulate(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GSProjectileSimulate);
+	SET_DWORD_STAT(STAT_GSProjectilesInFlight, Ids.Num());
+
+	AGSProjectileManager* ProjectileManager = Manager.Get();
+	const bool bAuthority = ProjectileManager->HasAuthority();
+	const float GravityZ = GetWorld()->GetGravityZ();
+
+	// 倒序遍历，移除时和末尾交换不会影响还没处理的元素
+	for (int32 Index = Ids.Num() - 1; Index >= 0; --Index)
+	{
+		const FGSProjectileType* Type = ProjectileManager->GetProjectileType(Types[Index]);
+		Ages[Index] += DeltaSeconds;
+		if (!Type || Ages[Index] > Type->Lifetime)
+		{
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		const FVector Acceleration(0.f, 0.f, GravityZ * Type->GravityScale);
+		const FVector Start = Positions[Index];
+		const FVector End = Start + Velocities[Index] * DeltaSeconds + 0.5f * Acceleration * DeltaSeconds * DeltaSeconds;
+
+		FHitResult Hit;
+		if (TraceStep(Start, End, *Type, Instigators[Index].Get(), Hit))
+		{
+			if (bAuthority)
+			{
+				HandleImpact(Index, *Type, Hit);
+			}
+			ProjectileManager->OnProjectileImpact(Types[Index], Hit.ImpactPoint, Hit.ImpactNormal);
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		Positions[Index] = End;
+		Velocities[Index] += Acceleration * DeltaSeconds;
+	}
+}
+
+bool UGSProjectileSubsystem::TraceStep(const FVector& Start, const FVector& End, const FGSProjectileType& Type,
+                                       const AActor* Instigator, FHitResult& OutHit) const
+{
+	const FCollisionQueryParams Params(SCENE_QUERY_STAT(GSProjectile), false, Instigator);
+
+	if (Type.CollisionRadius > 0.f)
+	{
+		return GetWorld()->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, COLLISION_PROJECTILE,
+		                                        FCollisionShape::MakeSphere(Type.CollisionRadius), Params);
+	}
+
+	return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, COLLISION_PROJECTILE, Params);
+}
+
+void UGSProjectileSubsystem::HandleImpact(int32 Index, const FGSProjectileType& Type, const FHitResult& Hit)
+{
+	AActor* Instigator = Instigators[Index].Get();
+
+	FGSProjectileImpact& Impact = PendingImpacts.AddDefaulted_GetRef();
+	Impact.Id = Ids[Index];
+	Impact.Location = Hit.ImpactPoint;
+	Impact.Normal = Hit.ImpactNormal;
+	Impact.Type = Types[Index];
+
+	if (Type.ExplosionRadius <= 0.f)
+	{
+		AddDamage(Instigator, Hit.GetActor(), Types[Index], Hit);
+		return;
+	}
+
+	// 爆炸对范围内每个 Actor 只计算一次，被墙挡住的不算，直接命中的目标总会受到伤害
+	ExplosionOverlaps.Reset();
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	GetWorld()->OverlapMultiByObjectType(ExplosionOverlaps, Hit.ImpactPoint, FQuat::Identity, ObjectParams,
+	                                     FCollisionShape::MakeSphere(Type.ExplosionRadius),
+	                                     FCollisionQueryParams(SCENE_QUERY_STAT(GSProjectileExplosion), false));
+
+	TArray<AActor*, TInlineAllocator<16>> DamagedActors;
+	for (const FOverlapResult& Overlap : ExplosionOverlaps)
+	{
+		AActor* Target = Overlap.GetActor();
+		if (!Target || DamagedActors.Contains(Target) || (Target == Instigator && !Type.bDamageInstigator))
+		{
+			continue;
+		}
+
+		if (Target != Hit.GetActor() && IsExplosionOccluded(Hit.ImpactPoint + Hit.ImpactNormal, Overlap))
+		{
+			continue;
+		}
+
+		DamagedActors.Add(Target);
+		AddDamage(Instigator, Target, Types[Index], Hit);
+	}
+}
+
+bool UGSProjectileSubsystem::IsExplosionOccluded(const FVector& Origin, const FOverlapResult& Overlap) const
+{
+	const UPrimitiveComponent* Component = Overlap.GetComponent();
+	if (!Component)
+	{
+		return true;
+	}
+
+	const FCollisionQueryParams Params(SCENE_QUERY_STAT(GSProjectileExplosionOcclusion), false, Overlap.GetActor());
+	return GetWorld()->LineTraceTestByChannel(Origin, Component->Bounds.Origin, ECC_Visibility, Params);
+}
+
+void UGSProjectileSubsystem::AddDamage(AActor* Instigator, AActor* Target, uint8 Type, const FHitResult& Hit)
+{
+	if (!Target || !UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target))
+	{
+		return;
+	}
+
+	const FGSProjectileType* ProjectileType = Manager->GetProjectileType(Type);
+	FAggregatedDamage* Entry = PendingDamage.FindByPredicate([Instigator, Target, Type](const FAggregatedDamage& Damage)
+	{
+		return Damage.Instigator.Get() == Instigator && Damage.Target.Get() == Target && Damage.Type == Type;
+	});
+
+	if (!Entry)
+	{
+		Entry = &PendingDamage.AddDefaulted_GetRef();
+		Entry->Instigator = Instigator;
+		Entry->Target = Target;
+		Entry->Type = Type;
+		Entry->HitResult = Hit;
+	}
+
+	Entry->Damage += ProjectileType->Damage;
+}
+
+void UGSProjectileSubsystem::ApplyAggregatedDamage()
+{
+	for (const FAggregatedDamage& Damage : PendingDamage)
+	{
+		const FGSProjectileType* Type = Manager->GetProjectileType(Damage.Type);
+		UAbilitySystemComponent* SourceASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Damage.Instigator.Get());
+		UAbilitySystemComponent* TargetASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Damage.Target.Get());
+		if (!Type || !Type->ImpactEffect || !SourceASC || !TargetASC)
+		{
+			continue;
+		}
+
+		FGameplayEffectContextHandle Context = SourceASC->MakeEffectContext();
+		Context.AddHitResult(Damage.HitResult);
+
+		FGameplayEffectSpecHandle Spec = SourceASC->MakeOutgoingSpec(Type->ImpactEffect, 1.f, Context);
+		if (Spec.IsValid())
+		{
+			Spec.Data->SetSetByCallerMagnitude(FGSGameplayTags::Get().Data_Damage, Damage.Damage);
+			SourceASC->ApplyGameplayEffectSpecToTarget(*Spec.Data.Get(), TargetASC);
+		}
+	}
+
+	PendingDamage.Reset();
+}
+
+void UGSProjectileSubsystem::RemoveProjectile(int32 Index)
+{
+	Ids.RemoveAtSwap(Index, 1, false);
+	Types.RemoveAtSwap(Index, 1, false);
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	Ages.RemoveAtSwap(Index, 1, false);
+	Instigators.RemoveAtSwap(Index, 1, false);
+}
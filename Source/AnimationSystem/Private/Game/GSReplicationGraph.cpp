@@ -0,0 +1,204 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Game/GSReplicationGraph.h"
+
+#include "Character/ALSBaseCharacter.h"
+#include "Characters/Heroes/GSHeroCharacter.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Items/Pickups/GSPickup.h"
+#include "Items/Weapons/GSWeapon.h"
+#include "UObject/UObjectIterator.h"
+
+void UGSReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(
+	const FConnectionGatherActorListParameters& Params)
+{
+	// PlayerController、Pawn、ViewTarget 由基类收集
+	Super::GatherActorListsForConnection(Params);
+
+	InventoryList.PrepareForWrite();
+	InventoryList.Reset();
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const AGSHeroCharacter* Hero = Cast<AGSHeroCharacter>(Viewer.ViewTarget);
+		if (!Hero && Viewer.InViewer)
+		{
+			Hero = Cast<AGSHeroCharacter>(Viewer.InViewer->GetPawn());
+		}
+		if (!Hero)
+		{
+			continue;
+		}
+
+		const FGSHeroInventory& Inventory = Hero->GetInventory();
+		for (AGSWeapon* Weapon : Inventory.Weapons)
+		{
+			if (IsValid(Weapon))
+			{
+				InventoryList.Add(Weapon);
+			}
+		}
+		for (AGSPickup* Item : Inventory.PickUpItems)
+		{
+			if (IsValid(Item))
+			{
+				InventoryList.Add(Item);
+			}
+		}
+	}
+
+	if (InventoryList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(InventoryList);
+	}
+}
+
+UGSReplicationGraph::UGSReplicationGraph()
+{
+}
+
+void UGSReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// 显式指定的路由，子类会沿继承链命中
+	ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), EGSClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EGSClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EGSClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AInfo::StaticClass(), EGSClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EGSClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(AALSBaseCharacter::StaticClass(), EGSClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AGSPickup::StaticClass(), EGSClassRepNodeMapping::Spatialize_Dormancy);
+
+	// 所有可复制的类都从 CDO 读取默认的剔除距离和复制间隔
+	const float MaxTickRate = NetDriver ? NetDriver->NetServerMaxTickRate : 30.f;
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (!ActorCDO || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// 跳过蓝图编译的中间类
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		// 角色和拾取物（包括蓝图子类）使用配置中的剔除距离
+		float CullDistanceSquared = ActorCDO->NetCullDistanceSquared;
+		if (Class->IsChildOf(AALSBaseCharacter::StaticClass()))
+		{
+			CullDistanceSquared = FMath::Square(CharacterCullDistance);
+		}
+		else if (Class->IsChildOf(AGSPickup::StaticClass()))
+		{
+			CullDistanceSquared = FMath::Square(PickupCullDistance);
+		}
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.SetCullDistanceSquared(CullDistanceSquared);
+		ClassInfo.ReplicationPeriodFrame = FMath::Max<uint32>(
+			FMath::RoundToInt(MaxTickRate / FMath::Max(ActorCDO->NetUpdateFrequency, 1.f)), 1);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UGSReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = SpatialCellSize;
+	GridNode->SpatialBias = SpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UGSReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	UGSReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode =
+		CreateNewNode<UGSReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(ConnectionNode, RepGraphConnection);
+}
+
+EGSClassRepNodeMapping UGSReplicationGraph::GetMappingPolicy(const UClass* Class)
+{
+	if (const EGSClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	// 未注册的类按 CDO 的相关性设置决定路由，并缓存结果
+	EGSClassRepNodeMapping Policy = EGSClassRepNodeMapping::Spatialize_Dynamic;
+	if (const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false)))
+	{
+		if (ActorCDO->bAlwaysRelevant)
+		{
+			Policy = EGSClassRepNodeMapping::RelevantAllConnections;
+		}
+		else if (ActorCDO->bOnlyRelevantToOwner)
+		{
+			Policy = EGSClassRepNodeMapping::NotRouted;
+		}
+		else if (!ActorCDO->GetRootComponent() || ActorCDO->GetRootComponent()->Mobility == EComponentMobility::Static)
+		{
+			Policy = EGSClassRepNodeMapping::Spatialize_Static;
+		}
+	}
+
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+void UGSReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo,
+                                                      FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EGSClassRepNodeMapping::NotRouted:
+		break;
+	case EGSClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EGSClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EGSClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EGSClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	}
+}
+
+void UGSReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EGSClassRepNodeMapping::NotRouted:
+		break;
+	case EGSClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EGSClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EGSClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EGSClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	}
+}
@@ -6,6 +6,7 @@
 #include "Characters/Abilities/GSAbilitySystemComponent.h"
 #include "Characters/Heroes/GSHeroCharacter.h"
 #include "Components/CapsuleComponent.h"
+#include "Game/GSInteractableSubsystem.h"
 
 
 // Sets default values
@@ -23,13 +24,10 @@ AGSASCActorBase::AGSASCActorBase(const FObjectInitializer& ObjectInitializer)
 	CollisionComp->SetCollisionResponseToAllChannels(ECR_Ignore);
 	CollisionComp->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
 	RootComponent = CollisionComp;
-	
-	// Create ability system component, and set it to be explicitly replicated
-	AbilitySystemComponent = CreateDefaultSubobject<UGSAbilitySystemComponent>(TEXT("AbilitySystemComponent"));
-	AbilitySystemComponent->SetIsReplicated(true);
 
-	// Minimal mode means GameplayEffects are not replicated to anyone. Only GameplayTags and Attributes are replicated to clients.
-	AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Minimal);
+	// 大部分物品在世界中不会运行能力，ASC 在 GetAbilitySystemComponent 中按需创建。
+	// 被拾取后 GivePickupTo 会直接使用角色的 ASC。
+	AbilitySystemComponent = nullptr;
 }
 
 // void AGSASCActorBase::NotifyActorBeginOverlap(AActor* Other)
@@ -46,6 +44,47 @@ AGSASCActorBase::AGSASCActorBase(const FObjectInitializer& ObjectInitializer)
 
 UAbilitySystemComponent* AGSASCActorBase::GetAbilitySystemComponent() const
 {
+	if (AbilitySystemComponent)
+	{
+		return AbilitySystemComponent;
+	}
+
+	// 客户端上被持有的物品：借用的角色 ASC 不会复制到物品上，从持有者获取
+	if (const IAbilitySystemInterface* OwnerInterface = Cast<IAbilitySystemInterface>(GetOwner()))
+	{
+		return OwnerInterface->GetAbilitySystemComponent();
+	}
+
+	// 服务器创建后复制到客户端的组件
+	return FindComponentByClass<UGSAbilitySystemComponent>();
+}
+
+UAbilitySystemComponent* AGSASCActorBase::GetOrCreateAbilitySystemComponent()
+{
+	UAbilitySystemComponent* ASC = GetAbilitySystemComponent();
+	if (!ASC && HasAuthority() && IsActorInitialized() && !IsPendingKillPending())
+	{
+		ASC = CreateAbilitySystemComponent();
+	}
+	return ASC;
+}
+
+UGSAbilitySystemComponent* AGSASCActorBase::CreateAbilitySystemComponent()
+{
+	check(HasAuthority());
+
+	// Create ability system component, and set it to be explicitly replicated
+	AbilitySystemComponent = NewObject<UGSAbilitySystemComponent>(this, TEXT("AbilitySystemComponent"));
+	AbilitySystemComponent->SetIsReplicated(true);
+
+	// Minimal mode means GameplayEffects are not replicated to anyone. Only GameplayTags and Attributes are replicated to clients.
+	AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Minimal);
+	AbilitySystemComponent->RegisterComponent();
+	AbilitySystemComponent->InitAbilityActorInfo(this, this);
+
+	// 休眠中的物品需要同步一次才能把新组件复制下去
+	FlushNetDormancy();
+
 	return AbilitySystemComponent;
 }
 
@@ -79,8 +118,22 @@ void AGSASCActorBase::TouchEnd(AGSHeroCharacter* Pawn)
 void AGSASCActorBase::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	AbilitySystemComponent->InitAbilityActorInfo(this, this);
+
+	// 注册到交互索引中，交互任务不再需要射线检测来寻找物体
+	if (UGSInteractableSubsystem* InteractableSubsystem = GetWorld()->GetSubsystem<UGSInteractableSubsystem>())
+	{
+		InteractableSubsystem->RegisterInteractable(this);
+	}
 	// CollisionComp->OnComponentBeginOverlap.Add(this, &AGSASCActorBase::NotifyActorBeginOverlap)
 }
 
+void AGSASCActorBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGSInteractableSubsystem* InteractableSubsystem = GetWorld()->GetSubsystem<UGSInteractableSubsystem>())
+	{
+		InteractableSubsystem->UnregisterInteractable(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
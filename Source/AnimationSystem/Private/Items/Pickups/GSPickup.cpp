@@ -7,6 +7,8 @@
 #include "Characters/GSCharacterBase.h"
 #include "Characters/Abilities/GSAbilitySystemComponent.h"
 #include "Characters/Abilities/GSGameplayAbility.h"
+#include "Components/CapsuleComponent.h"
+#include "Game/GSInteractableSubsystem.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
 #include "Sound/SoundCue.h"
@@ -18,6 +20,8 @@ AGSPickup::AGSPickup(const FObjectInitializer& ObjectInitializer)
 {
 	PrimaryActorTick.bCanEverTick = false;
 	bReplicates = true;
+	// 放在世界中的拾取物在状态改变前不参与复制
+	NetDormancy = DORM_Initial;
 	bIsActive = true;
 	bCanRespawn = true;
 	RespawnTime = 5.0f;
@@ -32,11 +36,23 @@ void AGSPickup::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetim
 
 	DOREPLIFETIME(AGSPickup, bIsActive);
 	DOREPLIFETIME(AGSPickup, PickedUpBy);
+	DOREPLIFETIME(AGSPickup, bInPool);
+}
+
+void AGSPickup::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// 客户端可能在 BeginPlay 之前就收到了 bInPool，这时交互索引还没有注册
+	if (bInPool)
+	{
+		ApplyPoolState();
+	}
 }
 
 bool AGSPickup::CanBePickedUp(AGSCharacterBase* TestCharacter) const
 {
-	return bIsActive && TestCharacter && TestCharacter->IsAlive() && !IsPendingKill() && !TestCharacter->GetAbilitySystemComponent()->HasAnyMatchingGameplayTags(RestrictedPickupTags) && K2_CanBePickedUp(TestCharacter);
+	return bIsActive && !bInPool && TestCharacter && TestCharacter->IsAlive() && !IsPendingKill() && !TestCharacter->GetAbilitySystemComponent()->HasAnyMatchingGameplayTags(RestrictedPickupTags) && K2_CanBePickedUp(TestCharacter);
 }
 
 bool AGSPickup::K2_CanBePickedUp_Implementation(AGSCharacterBase* TestCharacter) const
@@ -127,6 +143,12 @@ void AGSPickup::OnPickedUp()
 {
 	K2_OnPickedUp();
 
+	// 被持有后状态会频繁变化，保持唤醒
+	if (HasAuthority())
+	{
+		SetNetDormancy(DORM_Awake);
+	}
+
 	if (PickedUpBy)
 	{
 		
@@ -145,6 +167,9 @@ void AGSPickup::RespawnPickup()
 	PickedUpBy = NULL;
 	OnRespawned();
 
+	// 回到世界后同步这次变化，然后重新休眠
+	FlushPickupState();
+
 	TSet<AActor*> OverlappingPawns;
 	GetOverlappingActors(OverlappingPawns, AGSCharacterBase::StaticClass());
 
@@ -170,3 +195,76 @@ void AGSPickup::OnRep_IsActive()
 		OnPickedUp();
 	}
 }
+
+void AGSPickup::OnAcquiredFromPool()
+{
+	const AGSPickup* Defaults = GetClass()->GetDefaultObject<AGSPickup>();
+	CollisionComp->SetCollisionEnabled(Defaults->GetCollisionComp()->GetCollisionEnabled());
+
+	bIsActive = true;
+	bInPool = false;
+	ApplyPoolState();
+	FlushPickupState();
+}
+
+void AGSPickup::OnReleasedToPool()
+{
+	GetWorldTimerManager().ClearTimer(TimerHandle_RespawnPickup);
+
+	PickedUpBy = nullptr;
+	WantToPickUpBy = nullptr;
+
+	// 被拾取后用的是角色的 ASC，不再引用；物品自己的 ASC 保留下来复用
+	if (AbilitySystemComponent && AbilitySystemComponent->GetOwner() != this)
+	{
+		AbilitySystemComponent = nullptr;
+	}
+
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetOwner(nullptr);
+
+	bInPool = true;
+	ApplyPoolState();
+	FlushPickupState();
+}
+
+void AGSPickup::ApplyPoolState()
+{
+	SetActorHiddenInGame(bInPool);
+	SetActorEnableCollision(!bInPool);
+
+	// 交互索引在 BeginPlay 中注册，之前不需要处理
+	if (!HasActorBegunPlay())
+	{
+		return;
+	}
+
+	if (UGSInteractableSubsystem* InteractableSubsystem = GetWorld()->GetSubsystem<UGSInteractableSubsystem>())
+	{
+		if (bInPool)
+		{
+			InteractableSubsystem->UnregisterInteractable(this);
+		}
+		else
+		{
+			InteractableSubsystem->RegisterInteractable(this);
+		}
+	}
+}
+
+void AGSPickup::OnRep_InPool()
+{
+	ApplyPoolState();
+}
+
+void AGSPickup::FlushPickupState()
+{
+	if (NetDormancy == DORM_Awake)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+	else
+	{
+		FlushNetDormancy();
+	}
+}
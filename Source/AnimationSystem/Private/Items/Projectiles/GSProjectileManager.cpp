@@ -0,0 +1,132 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+
+#include "Items/Projectiles/GSProjectileManager.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Game/GSProjectileSubsystem.h"
+
+AGSProjectileManager::AGSProjectileManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	// 只通过 RPC 发送事件，没有需要同步的属性
+	NetUpdateFrequency = 1.f;
+	SetReplicatingMovement(false);
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(FName("Root"));
+}
+
+void AGSProjectileManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// 专用服务器不需要绘制
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		InstanceTransforms.SetNum(ProjectileTypes.Num());
+		for (const FGSProjectileType& Type : ProjectileTypes)
+		{
+			UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(this);
+			Component->SetStaticMesh(Type.Mesh);
+			Component->SetMobility(EComponentMobility::Movable);
+			Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			Component->SetCastShadow(false);
+			Component->SetUsingAbsoluteLocation(true);
+			Component->SetUsingAbsoluteRotation(true);
+			Component->SetupAttachment(RootComponent);
+			Component->RegisterComponent();
+			InstanceComponents.Add(Component);
+		}
+	}
+
+	if (UGSProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UGSProjectileSubsystem>())
+	{
+		ProjectileSubsystem->SetManager(this);
+	}
+}
+
+void AGSProjectileManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGSProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UGSProjectileSubsystem>())
+	{
+		if (ProjectileSubsystem->GetManager() == this)
+		{
+			ProjectileSubsystem->SetManager(nullptr);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AGSProjectileManager::MulticastSpawnVolley_Implementation(const FGSProjectileVolley& Volley)
+{
+	// 服务器在发射时已经生成过了
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	if (UGSProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UGSProjectileSubsystem>())
+	{
+		ProjectileSubsystem->SpawnVolley(Volley);
+	}
+}
+
+void AGSProjectileManager::MulticastImpacts_Implementation(const TArray<FGSProjectileImpact>& Impacts)
+{
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	if (UGSProjectileSubsystem* ProjectileSubsystem = GetWorld()->GetSubsystem<UGSProjectileSubsystem>())
+	{
+		ProjectileSubsystem->ApplyRemoteImpacts(Impacts);
+	}
+}
+
+void AGSProjectileManager::UpdateInstances(const TArray<uint8>& Types, const TArray<FVector>& Positions,
+                                           const TArray<FVector>& Velocities)
+{
+	if (InstanceComponents.Num() == 0)
+	{
+		return;
+	}
+
+	for (TArray<FTransform>& Transforms : InstanceTransforms)
+	{
+		Transforms.Reset();
+	}
+
+	for (int32 Index = 0; Index < Types.Num(); ++Index)
+	{
+		if (InstanceTransforms.IsValidIndex(Types[Index]))
+		{
+			InstanceTransforms[Types[Index]].Emplace(Velocities[Index].Rotation(), Positions[Index]);
+		}
+	}
+
+	for (int32 Type = 0; Type < InstanceComponents.Num(); ++Type)
+	{
+		UInstancedStaticMeshComponent* Component = InstanceComponents[Type];
+		const TArray<FTransform>& Transforms = InstanceTransforms[Type];
+
+		// 实例只在数量变化时增删，其余每帧整体更新
+		while (Component->GetInstanceCount() > Transforms.Num())
+		{
+			Component->RemoveInstance(Component->GetInstanceCount() - 1);
+		}
+		while (Component->GetInstanceCount() < Transforms.Num())
+		{
+			Component->AddInstanceWorldSpace(Transforms[Component->GetInstanceCount()]);
+		}
+
+		if (Transforms.Num() > 0)
+		{
+			Component->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+		}
+	}
+}
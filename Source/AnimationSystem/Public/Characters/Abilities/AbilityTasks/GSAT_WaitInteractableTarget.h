@@ -11,7 +11,8 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FWaitInteractableTargetDelegate, con
                                             Data);
 
 /**
- * 对计时器执行行跟踪，寻找实现IGSInteractable的Actor，该Actor可用于交互。
+ * 在计时器上寻找实现IGSInteractable的Actor，该Actor可用于交互。
+ * 候选物体从 UGSInteractableSubsystem 的空间索引中按视线锥查询，射线只用于确认最佳候选没有被遮挡。
  * StartLocations是硬编码的。
  * 如果只有一个起始位置，那么应该在AbilityTask节点上使用一个参数使其更通用。
  */
@@ -54,22 +55,43 @@ protected:
 
 	// bool bShowDebug = false;
 
-	bool bTraceAffectsAimPitch = false;
+	// 视线锥的半角，单位为度
+	float AimConeHalfAngle = 5.f;
+
+	// 视角和角色都静止时，检测间隔是 TimerPeriod 的多少倍
+	float IdlePeriodScale = 4.f;
+
+	// 转动视角达到这个角速度（度/秒）或移动达到这个速度时，按 TimerPeriod 检测
+	float FastTurnRate = 180.f;
+	float FastMoveSpeed = 600.f;
+
+	// 附近有可交互物体时才进行检测
+	bool bHasNearbyInteractable = false;
+
+	int32 ProximityWatcherId = INDEX_NONE;
+
+	FVector LastViewDir = FVector::ZeroVector;
+
+	float LastTraceTime = -1.f;
 
 	FCollisionProfileName TraceProfile;
 
-	FGameplayAbilityTargetDataHandle TargetData;
+	// 当前目标的检测结果，每次检测都原地改写，只在任务内部使用，不会广播出去
+	FHitResult CurrentTargetHit;
+
+	// 遮挡检测的参数，每次激活只构建一次
+	FCollisionQueryParams OcclusionQueryParams;
 
 	FTimerHandle TraceTimerHandle;
 
 	virtual void OnDestroy(bool AbilityEnded) override;
 
-	/** Traces as normal, but will manually filter all hit actors */
-	void LineTrace(FHitResult& OutHitResult, const UWorld* World, const FVector& Start, const FVector& End,
-	               FName ProfileName, const FCollisionQueryParams Params, bool bLookForInteractableActor) const;
+	// 计算玩家视线，以及从 TraceStart 出发、长度为 MaxRange 的瞄准终点，不做射线检测
+	void GetAimRay(const FVector& TraceStart, FVector& OutViewStart, FVector& OutViewDir, FVector& OutTraceEnd) const;
 
-	void AimWithPlayerController(const AActor* InSourceActor, FCollisionQueryParams Params, const FVector& TraceStart,
-	                             FVector& OutTraceEnd, bool bIgnorePitch = false) const;
+	// 在空间索引中查找最佳候选，并用一次射线确认它没有被遮挡
+	bool FindInteractableTarget(const AActor* SourceActor, const FVector& TraceStart, const FVector& ViewStart,
+	                            const FVector& ViewDir, FHitResult& OutHitResult) const;
 
 	// 将射线终点限制到一个合适的位置
 	bool ClipCameraRayToAbilityRange(FVector CameraLocation, FVector CameraDirection, FVector AbilityCenter,
@@ -78,6 +100,13 @@ protected:
 	UFUNCTION()
 	void PerformTrace();
 
+	void ScheduleNextTrace(float Delay);
+
+	// 交互索引通知附近是否有可交互物体
+	void OnProximityChanged(bool bHasNearby);
+
+	// 广播出去的 TargetData 可能被蓝图或 GameplayEvent 的 Payload 持有，每次广播都复制一份新的，
+	// 只在目标变化时分配
 	FGameplayAbilityTargetDataHandle MakeTargetData(const FHitResult& HitResult) const;
 private:
 	
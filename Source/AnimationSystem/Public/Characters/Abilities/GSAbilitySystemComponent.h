@@ -21,5 +21,28 @@ public:
 	bool bCharacterAbilitiesGiven = false;
 
 	virtual void AbilityLocalInputPressed(int32 InputID) override;
+
+protected:
+	// 维护 InputID 到能力的索引，客户端复制新增、移除能力时也会调用
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+
+private:
+	struct FGSInputBinding
+	{
+		FGameplayAbilitySpecHandle Handle;
+
+		// 能力在 ActivatableAbilities.Items 中的位置，移除其他能力后可能失效，使用前校验
+		int32 SpecIndex = INDEX_NONE;
+
+		// 从能力的 CDO 缓存下来，见 UGSGameplayAbility::bActivateOnInput
+		bool bActivateOnInput = false;
+	};
+
+	FGameplayAbilitySpec* FindSpecForBinding(FGSInputBinding& Binding);
+
+	// 按下输入时只遍历绑定到这个 InputID 的能力，而不是全部能力
+	TMultiMap<int32, FGSInputBinding> InputBindings;
 	
 };
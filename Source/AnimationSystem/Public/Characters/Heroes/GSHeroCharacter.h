@@ -6,24 +6,56 @@
 #include "AbilitySystemInterface.h"
 #include "Characters/GSCharacterBase.h"
 #include "Characters/Abilities/GSInteractable.h"
+#include "Engine/NetSerialization.h"
 #include "GameFramework/Character.h"
 #include "Items/Pickups/GSPickup.h"
 #include "Library/GSCharacterEnumLibrary.h"
 #include "GSHeroCharacter.generated.h"
 
 class AGASPlayerController;
+class AGSHeroCharacter;
+class AGSWeapon;
 class UMotionWarpingComponent;
+struct FGSHeroInventory;
+
+/**
+ * @brief 背包中的一个物品，增删改时在客户端单独回调。
+ */
 USTRUCT()
-struct ANIMATIONSYSTEM_API FGSHeroInventory
+struct ANIMATIONSYSTEM_API FGSHeroInventoryEntry : public FFastArraySerializerItem
 {
 	GENERATED_USTRUCT_BODY()
 
 	UPROPERTY()
-	TArray<AGSWeapon*> Weapons;
+	AGSPickup* Item = nullptr;
+
+	void PreReplicatedRemove(const FGSHeroInventory& InArraySerializer);
+	void PostReplicatedAdd(const FGSHeroInventory& InArraySerializer);
+	void PostReplicatedChange(const FGSHeroInventory& InArraySerializer);
+};
 
+USTRUCT()
+struct ANIMATIONSYSTEM_API FGSHeroInventory : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	// 只有这个数组参与复制，下面的都是本地缓存
 	UPROPERTY()
+	TArray<FGSHeroInventoryEntry> Items;
+
+	UPROPERTY(NotReplicated)
+	TArray<AGSWeapon*> Weapons;
+
+	UPROPERTY(NotReplicated)
 	TArray<AGSPickup*> PickUpItems;
 
+	// 以 WeaponTag 为键的武器索引
+	UPROPERTY(NotReplicated)
+	TMap<FGameplayTag, AGSWeapon*> WeaponsByTag;
+
+	UPROPERTY(NotReplicated)
+	AGSHeroCharacter* Owner = nullptr;
+
 	// Consumable items
 
 	// Passive items like armor
@@ -31,6 +63,31 @@ struct ANIMATIONSYSTEM_API FGSHeroInventory
 	// Door keys
 
 	// Etc
+
+	// 服务器端添加物品
+	void AddItem(AGSPickup* NewItem);
+
+	// 服务器端移除物品，不在背包中时返回 false
+	bool RemoveItem(AGSPickup* InItem);
+
+	AGSWeapon* FindWeapon(const FGameplayTag& WeaponTag) const;
+
+	void CacheItem(AGSPickup* InItem);
+	void UncacheItem(AGSPickup* InItem);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FGSHeroInventoryEntry, FGSHeroInventory>(Items, DeltaParams, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FGSHeroInventory> : public TStructOpsTypeTraitsBase2<FGSHeroInventory>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
 };
 
 UCLASS()
@@ -74,9 +131,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GAS|Inventory")
 	bool AddWeaponToInventory(AGSPickup* NewItem);
 
+	// 在服务器上把物品移出背包。移除的是武器时清除它的能力，是当前武器时卸下并同步给客户端
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "GAS|Inventory")
+	void RemoveItemFromInventory(AGSPickup* Item);
+
 	UFUNCTION(BlueprintCallable, Category = "GAS|Inventory")
 	AGSWeapon* GetCurrentWeapon() const { return CurrentWeapon; }
 
+	// 复制图按连接收集背包物品时使用。
+	const FGSHeroInventory& GetInventory() const { return Inventory; }
+
 	UFUNCTION(BlueprintCallable, Category = "GAS|Inventory")
 	void EquipWeapon(AGSWeapon* NewWeapon);
 
@@ -165,13 +229,17 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/**
 	 * @brief 判断该武器是否已经存在。
 	 */
-	bool DoesWeaponExistInInventory(const AGSWeapon* InWeapon);
+	bool DoesWeaponExistInInventory(const AGSWeapon* InWeapon) const;
 
-	UFUNCTION()
-	void OnRep_Inventory();
+	// 客户端收到背包物品的增删改
+	friend struct FGSHeroInventoryEntry;
+	void OnInventoryItemAdded(AGSPickup* Item);
+	void OnInventoryItemRemoved(AGSPickup* Item);
 
 	UFUNCTION()
 	void OnRep_CurrentWeapon(AGSWeapon* LastWeapon);
@@ -226,7 +294,7 @@ protected:
 
 	FSimpleMulticastDelegate InteractionCanceledDelegate;
 
-	UPROPERTY(ReplicatedUsing = OnRep_Inventory)
+	UPROPERTY(Replicated)
 	FGSHeroInventory Inventory;
 
 	UPROPERTY(ReplicatedUsing = OnRep_CurrentWeapon)
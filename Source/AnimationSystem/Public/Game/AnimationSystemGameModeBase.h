@@ -3,9 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Game/GSActorPoolSubsystem.h"
 #include "GameFramework/GameModeBase.h"
 #include "AnimationSystemGameModeBase.generated.h"
 
+class AGSProjectileManager;
 class UDataTable;
 /**
  * 
@@ -15,7 +17,11 @@ class ANIMATIONSYSTEM_API AAnimationSystemGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
 
-public:	
+public:
+	AAnimationSystemGameModeBase();
+
+	virtual void BeginPlay() override;
+
 	/*
 	 * Weapons
 	 */
@@ -38,4 +44,12 @@ protected:
 	
 	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = "GAS|Config")
 	UDataTable* PistolDB;
+
+	// 箭、火箭弹等抛射物的管理者，开始游戏时生成。抛射物的种类在蓝图子类中配置
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = "GAS|Config")
+	TSubclassOf<AGSProjectileManager> ProjectileManagerClass;
+
+	// 各个关卡开始时预先生成到对象池中的拾取物和武器，键为关卡名
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = "GAS|Config")
+	TMap<FName, FGSActorPoolManifest> ActorPoolManifests;
 };
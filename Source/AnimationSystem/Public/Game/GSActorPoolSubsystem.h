@@ -0,0 +1,90 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GSActorPoolSubsystem.generated.h"
+
+class AGSPickup;
+
+// 一种拾取物（或武器）需要预先生成的数量
+USTRUCT(BlueprintType)
+struct FGSActorPoolEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "GAS|Pool")
+	TSubclassOf<AGSPickup> ActorClass;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "GAS|Pool", meta = (ClampMin = "0"))
+	int32 Count = 0;
+};
+
+// 一个关卡开始时需要预热的对象池
+USTRUCT(BlueprintType)
+struct FGSActorPoolManifest
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "GAS|Pool")
+	TArray<FGSActorPoolEntry> Entries;
+};
+
+/**
+ * @brief 拾取物和武器的对象池，只在服务器上使用。
+ * 放回池中的 Actor 隐藏起来并关闭碰撞和物理，移到远处休眠；取出时通过 AGSPickup 的重置接口恢复状态，
+ * 这样掉落战利品和重新开局时不需要再生成 Actor（网格体、碰撞组件、ASC 都会保留下来）。
+ */
+UCLASS()
+class ANIMATIONSYSTEM_API UGSActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * @brief 按清单预先生成 Actor 并放入池中，已经在池中的数量会计算在内。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|Pool")
+	void Prewarm(const FGSActorPoolManifest& Manifest);
+
+	void PrewarmClass(TSubclassOf<AGSPickup> ActorClass, int32 Count);
+
+	/**
+	 * @brief 从池中取出一个 Actor 放到 Transform 处，池中没有时才生成新的。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|Pool", meta = (DeterminesOutputType = "ActorClass"))
+	AGSPickup* SpawnPooled(TSubclassOf<AGSPickup> ActorClass, const FTransform& Transform, AActor* Owner = nullptr);
+
+	/**
+	 * @brief 把 Actor 放回池中。不是由池生成的 Actor 也可以放入，之后会被复用。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|Pool")
+	void ReleaseToPool(AGSPickup* Actor);
+
+	/**
+	 * @brief 把所有从池中取出的 Actor 放回去，用于重新开局。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|Pool")
+	void ReleaseAll();
+
+	int32 GetNumFree(TSubclassOf<AGSPickup> ActorClass) const;
+
+protected:
+	// 池中的 Actor 停放的位置。复制图是二维网格，只看 XY，停在 Z 很低的地图中心仍然和玩家在同一个单元，
+	// 所以放到网格的角落（UGSReplicationGraph::SpatialBias），远离玩家活动的区域
+	FVector PoolLocation = FVector(-100000.f, -100000.f, -100000.f);
+
+private:
+	AGSPickup* SpawnNew(UClass* ActorClass, const FTransform& Transform, AActor* Owner) const;
+
+	// 重置 Actor 并放入空闲列表
+	void ReturnActor(AGSPickup* Actor);
+
+	TMap<UClass*, TArray<TWeakObjectPtr<AGSPickup>>> FreeActors;
+
+	// 从池中取出、还在使用中的 Actor
+	TSet<TWeakObjectPtr<AGSPickup>> ActiveActors;
+};
@@ -0,0 +1,63 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * @brief C++ 中使用的 GameplayTag，在模块启动时统一注册并缓存，
+ * 运行时直接读取，不再通过名字查找 TagManager。
+ */
+struct ANIMATIONSYSTEM_API FGSGameplayTags
+{
+	// CDO 构造早于模块 StartupModule，第一次访问时也会完成初始化
+	static const FGSGameplayTags& Get()
+	{
+		if (!GameplayTags.bInitialized)
+		{
+			InitializeNativeTags();
+		}
+		return GameplayTags;
+	}
+
+	// 模块启动时调用，注册所有原生 Tag 并检查它们是否在 DefaultGameplayTags.ini 中声明
+	static void InitializeNativeTags();
+
+	FGameplayTag Weapon_Equipped_None;
+	FGameplayTag Weapon_Equipped_Pistol;
+	FGameplayTag Weapon_Equipped_Rifle;
+	FGameplayTag Weapon_Equipped_Bow;
+
+	FGameplayTag Weapon_Ammo_None;
+	FGameplayTag Weapon_Ammo_Rifle;
+	FGameplayTag Weapon_Ammo_Rocket;
+	FGameplayTag Weapon_Ammo_Shotgun;
+
+	FGameplayTag Ability_Weapon;
+	FGameplayTag Ability_Weapon_IsChangingDelayReplication;
+	FGameplayTag Ability_Interaction;
+	FGameplayTag Ability_BlocksInteraction;
+	FGameplayTag Ability_Revive;
+
+	FGameplayTag State_Dead;
+	FGameplayTag State_KnockedDown;
+	FGameplayTag State_Interacting;
+	FGameplayTag State_InteractingRemoval;
+
+	FGameplayTag Data_Damage;
+	FGameplayTag Effect_Damage_HeadShot;
+
+private:
+	void AddAllTags();
+	void AddTag(FGameplayTag& OutTag, const ANSICHAR* TagName);
+
+	// 检查注册的 Tag 是否都能在配置中找到，缺失时启动失败
+	void ValidateAgainstConfig() const;
+
+	TArray<FName> RegisteredTagNames;
+
+	bool bInitialized = false;
+
+	static FGSGameplayTags GameplayTags;
+};
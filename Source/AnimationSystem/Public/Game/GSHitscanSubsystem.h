@@ -0,0 +1,72 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GSHitscanSubsystem.generated.h"
+
+class AGSWeapon;
+
+/**
+ * @brief 服务器上的即时命中射击管线。
+ * 武器把散布后的子弹放入队列，帧末统一发起异步场景查询（只查询场景，不含角色），
+ * 下一帧取回结果后对角色做延迟补偿回溯，再把同一把武器对同一个目标的伤害合并，每帧只应用一次 GameplayEffect。
+ */
+UCLASS()
+class ANIMATIONSYSTEM_API UGSHitscanSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// ShotTime 为回溯到的服务器时间
+	void QueueShot(AGSWeapon* Weapon, const FVector& Start, const FVector& Direction, float ShotTime);
+
+private:
+	struct FHitscanShot
+	{
+		TWeakObjectPtr<AGSWeapon> Weapon;
+		FVector Start = FVector::ZeroVector;
+		FVector Direction = FVector::ForwardVector;
+		float ShotTime = 0.f;
+		FTraceHandle TraceHandle;
+	};
+
+	// 一帧内同一把武器对同一个目标造成的伤害
+	struct FAggregatedDamage
+	{
+		TWeakObjectPtr<AGSWeapon> Weapon;
+		TWeakObjectPtr<AActor> Target;
+		float Damage = 0.f;
+		bool bHeadShot = false;
+		FHitResult HitResult;
+	};
+
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	void StartTraces();
+
+	// 场景查询的参数，异步查询和同步补查使用同一份
+	static FCollisionObjectQueryParams MakeWorldObjectParams();
+	static FCollisionQueryParams MakeWorldQueryParams(const AGSWeapon* Weapon);
+
+	void ResolveTracedShots();
+
+	void ResolveShot(const FHitscanShot& Shot, const FHitResult* WorldHit);
+
+	void AddDamage(AGSWeapon* Weapon, AActor* Target, bool bHeadShot, const FHitResult& HitResult);
+
+	void ApplyAggregatedDamage();
+
+	TArray<FHitscanShot> QueuedShots;
+
+	TArray<FHitscanShot> TracingShots;
+
+	TArray<FAggregatedDamage> PendingDamage;
+
+	FDelegateHandle PostActorTickHandle;
+};
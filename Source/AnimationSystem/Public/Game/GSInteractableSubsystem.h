@@ -0,0 +1,133 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GSInteractableSubsystem.generated.h"
+
+// 附近是否有可交互物体发生变化时回调
+DECLARE_DELEGATE_OneParam(FGSInteractableProximityDelegate, bool /*bHasNearby*/);
+
+// 一次交互目标查询的参数
+struct FGSInteractableQuery
+{
+	// 视线起点和方向（通常是玩家相机）
+	FVector ViewStart = FVector::ZeroVector;
+	FVector ViewDir = FVector::ForwardVector;
+
+	// 交互距离从这个点开始计算（通常是角色身上的插槽）
+	FVector RangeCenter = FVector::ZeroVector;
+	float MaxRange = 200.f;
+
+	// 视线锥的半角，单位为度
+	float ConeHalfAngle = 5.f;
+
+	const AActor* IgnoreActor = nullptr;
+};
+
+// 查询得到的候选组件
+struct FGSInteractableCandidate
+{
+	UPrimitiveComponent* Component = nullptr;
+
+	// 视线上距离组件包围球最近的点，作为命中点
+	FVector Location = FVector::ZeroVector;
+
+	// 沿视线方向的距离，越小越优先
+	float Distance = 0.f;
+};
+
+/**
+ * @brief 维护场景中可交互组件的空间网格。
+ * 交互任务先在网格中做视线锥查询，只对最佳候选做一次射线遮挡确认。
+ */
+UCLASS()
+class ANIMATIONSYSTEM_API UGSInteractableSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * @brief 注册实现了 IGSInteractable 的 Actor 的所有图元组件。
+	 * 碰撞响应在运行时可能改变，查询时才检查 COLLISION_INTERACTABLE 通道。
+	 */
+	void RegisterInteractable(AActor* Actor);
+
+	void UnregisterInteractable(AActor* Actor);
+
+	/**
+	 * @brief 在视线锥中查找沿视线最近、并且当前可交互的组件。
+	 */
+	bool FindBestInteractable(const FGSInteractableQuery& Query, FGSInteractableCandidate& OutCandidate) const;
+
+	/**
+	 * @brief 监听 Actor 周围 Radius 范围内是否有可交互物体。
+	 * 以网格单元为粒度判断（偏保守），只在 Actor 跨过单元边界或附近的物体增删、移动时重新计算，
+	 * 状态改变时回调 Delegate。
+	 * @param bOutHasNearby 注册时的初始状态
+	 * @return 用于移除监听的 Id
+	 */
+	int32 AddProximityWatcher(AActor* WatcherActor, float Radius, FGSInteractableProximityDelegate Delegate,
+	                          bool& bOutHasNearby);
+
+	void RemoveProximityWatcher(int32 WatcherId);
+
+protected:
+	// 网格单元大小，比交互距离大一些，使一次查询只覆盖少量单元
+	float CellSize = 500.f;
+
+private:
+	struct FProximityWatcher
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<USceneComponent> RootComponent;
+		FDelegateHandle TransformUpdatedHandle;
+		FGSInteractableProximityDelegate Delegate;
+		FIntVector Cell = FIntVector::ZeroValue;
+		float Radius = 0.f;
+		int32 CellRadius = 1;
+		bool bHasNearby = false;
+	};
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	// 组件按包围球中心放入网格，监听范围要加上最大的包围球半径
+	int32 GetWatcherCellRadius(float Radius) const;
+
+	// 记录注册过的最大包围球半径，变大时扩大所有监听者的范围
+	void UpdateMaxBoundsRadius(const UPrimitiveComponent* Component);
+
+	bool HasNearbyInteractable(const FProximityWatcher& Watcher) const;
+
+	// 重新计算监听者附近是否有物体，状态改变时回调
+	void UpdateWatcher(int32 WatcherId);
+
+	// 物体所在单元发生变化时，通知覆盖这些单元的监听者
+	void NotifyWatchersOfCellChange(const FIntVector& Cell);
+
+	void OnWatcherTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags,
+	                               ETeleportType Teleport, int32 WatcherId);
+
+	void AddComponent(UPrimitiveComponent* Component);
+
+	void RemoveComponent(UPrimitiveComponent* Component);
+
+	// 组件移动（比如掉落的武器）跨过单元边界时重新放入网格
+	void OnComponentTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags,
+	                                 ETeleportType Teleport);
+
+	TMap<FIntVector, TArray<TWeakObjectPtr<UPrimitiveComponent>>> Cells;
+
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, FIntVector> ComponentCells;
+
+	TMap<int32, FProximityWatcher> Watchers;
+
+	int32 NextWatcherId = 0;
+
+	// 注册过的组件中最大的包围球半径，查询时按它扩大扫描范围，
+	// 这样中心在扫描范围外、但包围球伸进交互距离的大组件（比如倒地角色的网格体）也能找到
+	float MaxBoundsRadius = 0.f;
+};
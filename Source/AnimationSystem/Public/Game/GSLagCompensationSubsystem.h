@@ -0,0 +1,174 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GSLagCompensationSubsystem.generated.h"
+
+class AGSCharacterBase;
+
+// 客户端上报的一发子弹，在服务器回溯到 ShotTime 时的位置进行验证
+USTRUCT(BlueprintType)
+struct FGSLagCompensatedShot
+{
+	GENERATED_BODY()
+
+	// 开枪的角色，不会命中自己，并用于检查射线起点是否可信
+	UPROPERTY(BlueprintReadWrite, Category = "GAS|LagCompensation")
+	AActor* Shooter = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, Category = "GAS|LagCompensation")
+	FVector Start = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadWrite, Category = "GAS|LagCompensation")
+	FVector Direction = FVector::ForwardVector;
+
+	UPROPERTY(BlueprintReadWrite, Category = "GAS|LagCompensation")
+	float Range = 10000.f;
+
+	// 服务器世界时间，通常由 GetRewindTime 得到
+	UPROPERTY(BlueprintReadWrite, Category = "GAS|LagCompensation")
+	float ShotTime = 0.f;
+};
+
+// 验证结果
+USTRUCT(BlueprintType)
+struct FGSLagCompensatedHit
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "GAS|LagCompensation")
+	bool bHit = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "GAS|LagCompensation")
+	AActor* HitActor = nullptr;
+
+	// 命中的骨骼球对应的骨骼
+	UPROPERTY(BlueprintReadOnly, Category = "GAS|LagCompensation")
+	FName BoneName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "GAS|LagCompensation")
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "GAS|LagCompensation")
+	float Distance = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "GAS|LagCompensation")
+	bool bHeadShot = false;
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FGSLagCompensatedShotDelegate, const FGSLagCompensatedHit&, Hit);
+
+// 用于回溯的骨骼命中盒，近似为球体
+struct FGSLagCompensationHitbox
+{
+	FName BoneName;
+	float Radius = 0.f;
+	bool bIsHead = false;
+};
+
+/**
+ * @brief 服务器上的延迟补偿。
+ * 每个服务器帧把角色的胶囊体和几个关键骨骼的位置记录到固定大小的环形缓冲中，
+ * 客户端上报的射击先排队，在帧末统一回溯到各自的时间，对快照做射线测试，不访问物理场景。
+ */
+UCLASS()
+class ANIMATIONSYSTEM_API UGSLagCompensationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UGSLagCompensationSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// 只在服务器上记录，注册时分配好环形缓冲
+	void RegisterCharacter(AGSCharacterBase* Character);
+
+	void UnregisterCharacter(AGSCharacterBase* Character);
+
+	/**
+	 * @brief 把一发子弹加入本帧的验证队列，帧末统一验证后回调 OnValidated。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|LagCompensation")
+	void QueueShot(const FGSLagCompensatedShot& Shot, const FGSLagCompensatedShotDelegate& OnValidated);
+
+	/**
+	 * @brief 估算玩家开枪时看到的服务器时间：当前时间减去半个往返延迟和插值延迟，最多回溯 MaxRewindTime。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|LagCompensation")
+	float GetRewindTime(const AController* ShooterController) const;
+
+	/**
+	 * @brief 立即回溯验证一发子弹，调用方自己已经按帧合批时使用。
+	 */
+	bool TraceShot(const FGSLagCompensatedShot& Shot, FGSLagCompensatedHit& OutHit) const;
+
+protected:
+	// 每个角色保留的快照帧数
+	int32 HistorySize = 64;
+
+	// 最多回溯多少秒，超过的按最早的快照处理
+	float MaxRewindTime = 0.4f;
+
+	// 客户端渲染其他角色时的插值延迟
+	float InterpolationDelay = 0.1f;
+
+	// 射线起点与开枪角色回溯位置的最大偏差，超过则认为不可信
+	float MaxShotStartOffset = 200.f;
+
+	TArray<FGSLagCompensationHitbox> Hitboxes;
+
+private:
+	static constexpr int32 MaxHitboxes = 11;
+
+	// 一帧中一个角色的命中盒
+	struct FHitboxSnapshot
+	{
+		float Time = 0.f;
+		FVector CapsuleCenter = FVector::ZeroVector;
+		float CapsuleHalfHeight = 0.f;
+		float CapsuleRadius = 0.f;
+		FVector BoneLocations[MaxHitboxes];
+	};
+
+	struct FCharacterHistory
+	{
+		TWeakObjectPtr<AGSCharacterBase> Character;
+		int32 BoneIndices[MaxHitboxes];
+		TArray<FHitboxSnapshot> Frames;
+		int32 Head = INDEX_NONE;
+		int32 Count = 0;
+	};
+
+	struct FPendingShot
+	{
+		FGSLagCompensatedShot Shot;
+		FGSLagCompensatedShotDelegate OnValidated;
+	};
+
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	void RecordSnapshots(float Time);
+
+	void ValidatePendingShots();
+
+	// 在两帧快照之间插值得到 Time 时刻的命中盒
+	void GetSnapshotAtTime(const FCharacterHistory& History, float Time, FHitboxSnapshot& OutSnapshot) const;
+
+	bool TraceSnapshot(const FGSLagCompensatedShot& Shot, const FHitboxSnapshot& Snapshot,
+	                   FGSLagCompensatedHit& OutHit) const;
+
+	const FCharacterHistory* FindHistory(const AActor* Actor) const;
+
+	TArray<FCharacterHistory> Histories;
+
+	TArray<FPendingShot> PendingShots;
+
+	TArray<FPendingShot> ValidatingShots;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,94 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Items/Projectiles/GSProjectileManager.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GSProjectileSubsystem.generated.h"
+
+/**
+ * @brief 所有飞行中的抛射物在这里统一模拟，不再为每支箭、每发火箭弹生成一个 Actor。
+ * 状态按字段存放在连续的数组中，每帧对每发抛射物做一次线段（或球体）扫掠，
+ * 服务器负责结算伤害并广播命中，客户端根据齐射事件自行模拟表现。
+ */
+UCLASS()
+class ANIMATIONSYSTEM_API UGSProjectileSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * @brief 在服务器上发射一次齐射，Count 发抛射物在 SpreadAngle（度）的锥形内散布。
+	 * 弓箭和火箭筒的开火能力在蓝图中，需要改为调用这里才会走共享模拟。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|Projectile")
+	void FireProjectiles(AActor* Instigator, uint8 Type, FVector Origin, FVector Direction, int32 Count = 1,
+	                     float SpreadAngle = 0.f);
+
+	// 根据齐射事件生成抛射物，客户端会补上网络延迟这段时间的飞行
+	void SpawnVolley(const FGSProjectileVolley& Volley);
+
+	// 客户端收到服务器的命中事件，移除本地还在飞的抛射物
+	void ApplyRemoteImpacts(const TArray<FGSProjectileImpact>& Impacts);
+
+	void SetManager(AGSProjectileManager* InManager) { Manager = InManager; }
+
+	AGSProjectileManager* GetManager() const { return Manager.Get(); }
+
+	int32 GetNumProjectiles() const { return Ids.Num(); }
+
+private:
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	void Simulate(float DeltaSeconds);
+
+	bool TraceStep(const FVector& Start, const FVector& End, const FGSProjectileType& Type, const AActor* Instigator,
+	               FHitResult& OutHit) const;
+
+	// 服务器上记录命中造成的伤害
+	void HandleImpact(int32 Index, const FGSProjectileType& Type, const FHitResult& Hit);
+
+	// 爆炸中心到目标之间有阻挡时不造成伤害
+	bool IsExplosionOccluded(const FVector& Origin, const FOverlapResult& Overlap) const;
+
+	void AddDamage(AActor* Instigator, AActor* Target, uint8 Type, const FHitResult& Hit);
+
+	void ApplyAggregatedDamage();
+
+	void RemoveProjectile(int32 Index);
+
+	// 每发抛射物的状态，下标一一对应
+	TArray<uint32> Ids;
+	TArray<uint8> Types;
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> Ages;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+
+	// 同一帧同一个发射者对同一个目标的伤害合并成一次效果
+	struct FAggregatedDamage
+	{
+		TWeakObjectPtr<AActor> Instigator;
+		TWeakObjectPtr<AActor> Target;
+		uint8 Type = 0;
+		float Damage = 0.f;
+		FHitResult HitResult;
+	};
+
+	TArray<FAggregatedDamage> PendingDamage;
+
+	TArray<FGSProjectileImpact> PendingImpacts;
+
+	TArray<FOverlapResult> ExplosionOverlaps;
+
+	TWeakObjectPtr<AGSProjectileManager> Manager;
+
+	uint32 NextProjectileId = 1;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,81 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "GSReplicationGraph.generated.h"
+
+// Actor 类型到复制图节点的路由方式
+UENUM()
+enum class EGSClassRepNodeMapping : uint8
+{
+	NotRouted,				// 不进入全局节点，由连接节点处理（如 PlayerController）
+	RelevantAllConnections,	// 对所有连接相关
+	Spatialize_Static,		// 空间网格中不移动的 Actor
+	Spatialize_Dynamic,		// 空间网格中每帧更新位置的 Actor（角色）
+	Spatialize_Dormancy,	// 休眠时视为静态，唤醒后视为动态（拾取物、武器）
+};
+
+/**
+ * 按连接收集拥有者专属的 Actor：
+ * 除了基类的 PlayerController / Pawn / ViewTarget，还包括英雄背包里的武器和拾取物。
+ */
+UCLASS()
+class ANIMATIONSYSTEM_API UGSReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	FActorRepListRefView InventoryList;
+};
+
+/**
+ * 游戏的复制图：
+ * 角色和世界中的拾取物走 2D 空间网格，背包物品只对拥有者的连接常驻相关，
+ * 地面上的拾取物以休眠方式进入网格，不再每帧参与相关性计算。
+ */
+UCLASS(Transient, Config = Engine)
+class ANIMATIONSYSTEM_API UGSReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UGSReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	// 网格单元大小
+	UPROPERTY(Config)
+	float SpatialCellSize = 10000.f;
+
+	// 网格原点偏移，关卡坐标为负时避免网格频繁扩张
+	UPROPERTY(Config)
+	FVector2D SpatialBias = FVector2D(-100000.f, -100000.f);
+
+	// 角色的复制剔除距离
+	UPROPERTY(Config)
+	float CharacterCullDistance = 15000.f;
+
+	// 拾取物和武器的复制剔除距离
+	UPROPERTY(Config)
+	float PickupCullDistance = 5000.f;
+
+private:
+	EGSClassRepNodeMapping GetMappingPolicy(const UClass* Class);
+
+	TClassMap<EGSClassRepNodeMapping> ClassRepNodePolicies;
+};
@@ -29,8 +29,17 @@ public:
 	// virtual void NotifyActorEndOverlap(AActor* OtherActor) override;
 	
 	// Implement IAbilitySystemInterface
+	// 物品默认不带 ASC，这里只返回已有的组件，不会创建。
+	// 被持有的物品使用持有者的 ASC（客户端上通过 Owner 获取）。
 	virtual class UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 
+	/**
+	 * @brief 获取物品的 ASC，没有时在服务器上创建物品自身的 ASC。
+	 * 只在确实需要物品运行能力或接收效果的地方调用，通用的查找（比如伤害结算）使用 GetAbilitySystemComponent。
+	 */
+	UFUNCTION(BlueprintCallable, Category = "GAS|Ability")
+	class UAbilitySystemComponent* GetOrCreateAbilitySystemComponent();
+
 	// /**
 	//  * @brief 设置该武器对应角色的覆盖类型
 	//  */
@@ -40,6 +49,8 @@ public:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/*
 	 * 如果该函数没有被重载，就会调用对应的蓝图函数，使用蓝图函数
 	 * 如果重载了该函数，就可以实现C++和蓝图混合使用。
@@ -64,6 +75,11 @@ public:
 	void K2_TouchEnd(AGSHeroCharacter* Pawn);
 
 protected:
+	/**
+	 * @brief 在服务器上创建并注册物品自身的 ASC。
+	 */
+	class UGSAbilitySystemComponent* CreateAbilitySystemComponent();
+
 	UPROPERTY()
 	class UGSAbilitySystemComponent* AbilitySystemComponent;
 
@@ -19,6 +19,8 @@ public:
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	virtual void BeginPlay() override;
+
 	// Check if pawn can use this pickup
 	virtual bool CanBePickedUp(AGSCharacterBase* TestCharacter) const;
 
@@ -44,6 +46,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GAS|PickUp")
 	UAnimMontage* GetPickUpMontage(EALSStance Stance) const;
 
+	/*
+	 * 对象池，见 UGSActorPoolSubsystem
+	 */
+
+	/**
+	 * @brief 从对象池中取出时在服务器上调用，恢复成刚生成在世界中的状态。
+	 */
+	virtual void OnAcquiredFromPool();
+
+	/**
+	 * @brief 放回对象池时在服务器上调用，清除拾取状态并隐藏、关闭碰撞。
+	 */
+	virtual void OnReleasedToPool();
+
+	bool IsInPool() const { return bInPool; }
+
 	// /*
 	//  * IGSInteractable
 	//  */
@@ -71,6 +89,15 @@ protected:
 	UFUNCTION()
 	virtual void OnRep_IsActive();
 
+	// 按 bInPool 设置显示、碰撞和交互索引，服务器和客户端都会调用
+	virtual void ApplyPoolState();
+
+	UFUNCTION()
+	virtual void OnRep_InPool();
+
+	// 状态改变后同步一次，然后重新休眠
+	void FlushPickupState();
+
 
 public:
 	// UPROPERTY(BlueprintReadOnly, Category = "GAS|PickUp|Animation")
@@ -95,6 +122,10 @@ protected:
 	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_IsActive, Category = "GAS|PickUp")
 	bool bIsActive;
 
+	// 是否在对象池中闲置
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_InPool, Category = "GAS|PickUp")
+	bool bInPool = false;
+
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "GAS|PickUp")
 	bool bCanRespawn;
 
@@ -0,0 +1,156 @@
+﻿// Copyright ©2022 Tanzq. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/Actor.h"
+#include "GSProjectileManager.generated.h"
+
+class UGameplayEffect;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+// 一种抛射物（箭、火箭弹）的参数
+USTRUCT(BlueprintType)
+struct FGSProjectileType
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	UStaticMesh* Mesh = nullptr;
+
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	float Speed = 5000.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	float GravityScale = 1.f;
+
+	// 超过这个时间还没有命中就消失
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	float Lifetime = 5.f;
+
+	// 大于 0 时用球体扫掠，否则用射线
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	float CollisionRadius = 0.f;
+
+	// 命中时的伤害效果，伤害值通过 SetByCaller(Data.Damage) 传入
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	TSubclassOf<UGameplayEffect> ImpactEffect;
+
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	float Damage = 10.f;
+
+	// 大于 0 时对范围内的所有目标造成伤害（火箭弹）
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	float ExplosionRadius = 0.f;
+
+	// 爆炸是否也伤害发射者自己
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	bool bDamageInstigator = false;
+};
+
+// 一次齐射，客户端用种子还原每一发的方向
+USTRUCT()
+struct FGSProjectileVolley
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	AActor* Instigator = nullptr;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Origin;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	// 散布半角，单位为度
+	UPROPERTY()
+	float SpreadAngle = 0.f;
+
+	UPROPERTY()
+	int32 Seed = 0;
+
+	// 第一发的 Id，后面的依次加一
+	UPROPERTY()
+	uint32 FirstId = 0;
+
+	UPROPERTY()
+	float ServerTime = 0.f;
+
+	UPROPERTY()
+	uint8 Type = 0;
+
+	UPROPERTY()
+	uint8 Count = 1;
+};
+
+// 服务器上的命中事件
+USTRUCT()
+struct FGSProjectileImpact
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint32 Id = 0;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Location;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Normal;
+
+	UPROPERTY()
+	uint8 Type = 0;
+};
+
+/**
+ * @brief 抛射物的网络和渲染代理，由 GameMode 在服务器上生成，对所有连接相关。
+ * 只同步齐射和命中事件，每种抛射物用一个 InstancedStaticMesh 绘制，模拟在 UGSProjectileSubsystem 中。
+ */
+UCLASS(Blueprintable)
+class ANIMATIONSYSTEM_API AGSProjectileManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGSProjectileManager();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	const FGSProjectileType* GetProjectileType(uint8 Type) const
+	{
+		return ProjectileTypes.IsValidIndex(Type) ? &ProjectileTypes[Type] : nullptr;
+	}
+
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastSpawnVolley(const FGSProjectileVolley& Volley);
+	void MulticastSpawnVolley_Implementation(const FGSProjectileVolley& Volley);
+
+	// 一帧内的命中合并成一次 RPC
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastImpacts(const TArray<FGSProjectileImpact>& Impacts);
+	void MulticastImpacts_Implementation(const TArray<FGSProjectileImpact>& Impacts);
+
+	// 用模拟结果更新每种抛射物的实例
+	void UpdateInstances(const TArray<uint8>& Types, const TArray<FVector>& Positions,
+	                     const TArray<FVector>& Velocities);
+
+	// 播放命中特效
+	UFUNCTION(BlueprintImplementableEvent, Meta = (DisplayName = "OnProjectileImpact"))
+	void OnProjectileImpact(uint8 Type, FVector Location, FVector Normal);
+
+protected:
+	// 下标即抛射物类型
+	UPROPERTY(EditDefaultsOnly, Category = "GAS|Projectile")
+	TArray<FGSProjectileType> ProjectileTypes;
+
+	UPROPERTY(Transient)
+	TArray<UInstancedStaticMeshComponent*> InstanceComponents;
+
+	// 每种抛射物本帧的实例变换，重复使用避免每帧分配
+	TArray<TArray<FTransform>> InstanceTransforms;
+};
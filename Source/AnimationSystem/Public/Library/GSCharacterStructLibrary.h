@@ -6,9 +6,11 @@
 #include "Engine/DataTable.h"
 #include "GSCharacterStructLibrary.generated.h"
 
+class USoundCue;
 
 /**
  * @brief 步枪数据表类型
+ * 资源都是软引用，在武器靠近玩家或被交互检测选中时才开始异步加载。
  */
 USTRUCT(BlueprintType) 
 struct FRifleAssetsInfo : public FTableRowBase {
@@ -21,13 +23,13 @@ struct FRifleAssetsInfo : public FTableRowBase {
 	// EGSRifleModel EnumName = EGSRifleModel::M4A1;
 	
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Rifle Assets")
-	USkeletalMesh* SkeletalMesh;
+	TSoftObjectPtr<USkeletalMesh> SkeletalMesh;
 
 	// UPROPERTY(EditAnywhere, Category = "Rifle Assets")
 	// UPhysicsAsset* PhysicAssets;
 
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Rifle Assets")
-	UStaticMesh* MagazineMesh;
+	TSoftObjectPtr<UStaticMesh> MagazineMesh;
 
 	UPROPERTY( EditAnywhere, Category = "Rifle Assets")
 	FName MagazineSocketName = FName("magazineSocket");
@@ -36,7 +38,7 @@ struct FRifleAssetsInfo : public FTableRowBase {
 	FName MuzzleSocketName = FName("BulletStart");
 
 	UPROPERTY(EditAnywhere, Category = "Rifle Assets")
-	class USoundCue* ShootingSound;
+	TSoftObjectPtr<USoundCue> ShootingSound;
 
 	UPROPERTY(EditAnywhere, Category = "Rifle Assets")
 	bool HeadShotDeath = false;
@@ -58,10 +60,20 @@ struct FRifleAssetsInfo : public FTableRowBase {
 
 	UPROPERTY(EditAnywhere, Category = "Rifle Assets")
 	FRotator MagazineRelativeRot;
+
+	// 收集需要一起加载的资源
+	void AppendAssetPaths(TArray<FSoftObjectPath>& OutPaths) const
+	{
+		OutPaths.Add(SkeletalMesh.ToSoftObjectPath());
+		OutPaths.Add(MagazineMesh.ToSoftObjectPath());
+		OutPaths.Add(ShootingSound.ToSoftObjectPath());
+		OutPaths.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+	}
 };
 
 /**
  * @brief 手枪数据表类型
+ * 资源都是软引用，在武器靠近玩家或被交互检测选中时才开始异步加载。
  */
 USTRUCT(BlueprintType) 
 struct FPistolsAssetsInfo : public FTableRowBase {
@@ -74,13 +86,13 @@ struct FPistolsAssetsInfo : public FTableRowBase {
 	// EGSPistolModel EnumName = EGSPistolModel::M9;
 	
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Rifle Assets")
-	USkeletalMesh* SkeletalMesh;
+	TSoftObjectPtr<USkeletalMesh> SkeletalMesh;
 
 	// UPROPERTY(EditAnywhere, Category = "Rifle Assets")
 	// UPhysicsAsset* PhysicAssets;
 
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Rifle Assets")
-	UStaticMesh* MagazineMesh;
+	TSoftObjectPtr<UStaticMesh> MagazineMesh;
 
 	UPROPERTY(EditAnywhere, Category = "Rifle Assets")
 	FName MagazineSocketName = FName("magazineSocket");
@@ -89,7 +101,7 @@ struct FPistolsAssetsInfo : public FTableRowBase {
 	FName MuzzleSocketName = FName("BulletStart");
 
 	UPROPERTY(EditAnywhere, Category = "Rifle Assets")
-	USoundCue* ShootingSound;
+	TSoftObjectPtr<USoundCue> ShootingSound;
 
 	UPROPERTY(EditAnywhere, Category = "Rifle Assets")
 	bool bWithSilencer = false;
@@ -104,5 +116,15 @@ struct FPistolsAssetsInfo : public FTableRowBase {
 	int32 MaxAmmoCountPerMagazine = 15;
 
 	UPROPERTY(EditAnywhere, Category = "Rifle Assets")
-	TSubclassOf<UAnimInstance> AnimBlueprint;
+	TSoftClassPtr<UAnimInstance> AnimBlueprint;
+
+	// 收集需要一起加载的资源
+	void AppendAssetPaths(TArray<FSoftObjectPath>& OutPaths) const
+	{
+		OutPaths.Add(SkeletalMesh.ToSoftObjectPath());
+		OutPaths.Add(MagazineMesh.ToSoftObjectPath());
+		OutPaths.Add(ShootingSound.ToSoftObjectPath());
+		OutPaths.Add(AnimBlueprint.ToSoftObjectPath());
+		OutPaths.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+	}
 };
\ No newline at end of file